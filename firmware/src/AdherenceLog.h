@@ -0,0 +1,210 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+
+// Append-only log of doses, kept in a ring of two byte records in EEPROM.
+//
+//   byte 0: bit 7     pass bit, flips each time the ring wraps
+//           bits 6-4  alarm index, 7 when the slot was never written
+//           bits 3-0  day of the alarm, modulo 16
+//   byte 1: minutes from alarm to reset (0 to 254), 255 if not acknowledged
+//
+// Firing an alarm writes byte 0 (plus byte 1 when reusing a slot) and a
+// reset writes byte 1, so each event costs one or two EEPROM bytes and no
+// header is needed. The write position is found from the pass bits and the
+// day of each record is rebuilt by walking back from today, using the day
+// differences between records. Gaps of 16 days or more can not be told apart.
+// The ring should hold more than a week of doses, records are evicted from
+// the missed count only by ageing out of the week.
+
+#define ADHERENCE_MISSED 255
+
+class AdherenceLog
+{
+public:
+  AdherenceLog(int baseAddress, uint16_t numRecords) : baseAddress(baseAddress), numRecords(numRecords) {}
+
+  // Find the write position and rebuild the running aggregates.
+  void begin(uint16_t today)
+  {
+    memset(bucketDay, 0, sizeof(bucketDay));
+    memset(bucketMissed, 0, sizeof(bucketMissed));
+    responseTotal = 0;
+    responseCount = 0;
+    pendingFlag = false;
+
+    head = 0;
+    full = false;
+    if (!isWritten(0))
+    {
+      return;
+    }
+
+    bool pass = readByte(0) & 0x80;
+    while (head < numRecords && isWritten(head) && (bool)(readByte(head) & 0x80) == pass)
+    {
+      head++;
+    }
+    if (head == numRecords)
+    {
+      head = 0;
+      full = true;
+    }
+    else if (isWritten(head))
+    {
+      full = true;
+    }
+
+    // Walk back from the newest record. A dose still open at power loss
+    // counts as missed, the indicator does not survive a reset.
+    uint16_t count = full ? numRecords : head;
+    uint16_t day = today;
+    uint8_t dayBits = today & 0x0F;
+    uint16_t index = head;
+    for (uint16_t i = 0; i < count; i++)
+    {
+      index = index == 0 ? numRecords - 1 : index - 1;
+      uint8_t recordDayBits = readByte(index) & 0x0F;
+      day -= (dayBits - recordDayBits) & 0x0F;
+      dayBits = recordDayBits;
+
+      addToAggregates(day, readByte(index, 1));
+    }
+  }
+
+  // An alarm fired. A previous dose that was never acknowledged is missed.
+  void fired(uint8_t alarm, uint32_t nowSeconds)
+  {
+    if (pendingFlag)
+    {
+      addToAggregates(pendingDay, ADHERENCE_MISSED);
+    }
+
+    // Evict the oldest record from the aggregates before reusing its slot.
+    if (full)
+    {
+      uint8_t minutes = readByte(head, 1);
+      if (minutes != ADHERENCE_MISSED)
+      {
+        responseTotal -= minutes;
+        responseCount--;
+      }
+    }
+
+    uint16_t day = nowSeconds / 86400;
+    bool pass = head == 0 ? !currentPass() : (readByte(0) & 0x80);
+    writeByte(head, 0, (pass ? 0x80 : 0) | ((alarm & 0x07) << 4) | (day & 0x0F));
+    writeByte(head, 1, ADHERENCE_MISSED);
+
+    pendingFlag = true;
+    pendingIndex = head;
+    pendingDay = day;
+    pendingSeconds = nowSeconds;
+
+    head++;
+    if (head == numRecords)
+    {
+      head = 0;
+      full = true;
+    }
+  }
+
+  // The reset button was pressed while a dose was pending.
+  void acknowledged(uint32_t nowSeconds)
+  {
+    if (!pendingFlag)
+    {
+      return;
+    }
+    pendingFlag = false;
+
+    uint32_t minutes = (nowSeconds - pendingSeconds) / 60;
+    if (minutes >= ADHERENCE_MISSED)
+    {
+      minutes = ADHERENCE_MISSED - 1;
+    }
+    writeByte(pendingIndex, 1, minutes);
+    addToAggregates(pendingDay, minutes);
+  }
+
+  uint8_t missedThisWeek(uint16_t today)
+  {
+    uint8_t missed = 0;
+    for (uint8_t i = 0; i < 7; i++)
+    {
+      if ((uint16_t)(today - bucketDay[i]) < 7)
+      {
+        missed += bucketMissed[i];
+      }
+    }
+    return missed;
+  }
+
+  uint8_t meanResponseMinutes()
+  {
+    return responseCount ? responseTotal / responseCount : 0;
+  }
+
+private:
+  bool isWritten(uint16_t index)
+  {
+    return (readByte(index) & 0x70) != 0x70;
+  }
+
+  bool currentPass()
+  {
+    // Pass bit of the newest record, an empty log starts as if on pass 1.
+    if (!full && head == 0)
+    {
+      return true;
+    }
+    return readByte(head == 0 ? numRecords - 1 : head - 1) & 0x80;
+  }
+
+  uint8_t readByte(uint16_t index, uint8_t offset = 0)
+  {
+    return EEPROM.read(baseAddress + index * 2 + offset);
+  }
+
+  void writeByte(uint16_t index, uint8_t offset, uint8_t value)
+  {
+    EEPROM.update(baseAddress + index * 2 + offset, value);
+  }
+
+  void addToAggregates(uint16_t day, uint8_t minutes)
+  {
+    if (minutes != ADHERENCE_MISSED)
+    {
+      responseTotal += minutes;
+      responseCount++;
+      return;
+    }
+
+    // Older days sharing a bucket are more than a week old, skip them.
+    uint8_t bucket = day % 7;
+    if (day > bucketDay[bucket])
+    {
+      bucketDay[bucket] = day;
+      bucketMissed[bucket] = 0;
+    }
+    if (day == bucketDay[bucket])
+    {
+      bucketMissed[bucket]++;
+    }
+  }
+
+  int baseAddress;
+  uint16_t numRecords;
+  uint16_t head;
+  bool full;
+
+  bool pendingFlag;
+  uint16_t pendingIndex;
+  uint16_t pendingDay;
+  uint32_t pendingSeconds;
+
+  // Missed doses per day for the last week, keyed by day % 7.
+  uint16_t bucketDay[7];
+  uint8_t bucketMissed[7];
+  uint32_t responseTotal;
+  uint16_t responseCount;
+};
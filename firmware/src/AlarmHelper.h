@@ -0,0 +1,41 @@
+#include <stdint.h>
+
+// Kept free of Arduino and RTC calls so the alarm logic can be driven
+// from a fake clock on the host.
+
+struct Alarm
+{
+  uint8_t hour;
+  uint8_t minute;
+};
+
+// Tracks the last seen clock minute so each alarm triggers only once,
+// upon the time clocking into the alarm value.
+struct AlarmClock
+{
+  int lastHour;
+  int lastMinute;
+};
+
+// Returns the index of the alarm the time has just clocked into, or -1.
+int CheckAlarms(AlarmClock &clock, const Alarm *alarms, int numAlarms, int hour, int minute)
+{
+  if (clock.lastHour == hour && clock.lastMinute == minute)
+  {
+    return -1;
+  }
+
+  clock.lastHour = hour;
+  clock.lastMinute = minute;
+
+  for (int i = 0; i < numAlarms; i++)
+  {
+    if (hour == alarms[i].hour && minute == alarms[i].minute)
+    {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
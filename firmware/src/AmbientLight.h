@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "BoardProfile.h"
+
+// Ambient light level from a light sensor on an analog pin.
+//
+// The ADC runs free, interrupt driven, at its slowest clock (about 4.8 kHz
+// at 8 MHz), so loop() never waits on a conversion the way analogRead()
+// does. The ISR sums 16 samples and feeds each sum through a first order IIR
+// filter in integer math, a time constant of about 0.2 s. The sensor should
+// read higher when brighter, e.g. a light dependent resistor to AVcc and a
+// fixed resistor to ground. The ISR and the ADC setup are only compiled for
+// profiles with BOARD_HAS_LIGHT_SENSOR.
+
+class AmbientLight
+{
+public:
+  static const uint8_t decimation = 16;
+  static const uint8_t filterShift = 6;
+
+  // Called with each conversion, from the ADC interrupt.
+  void addSample(uint16_t raw)
+  {
+    sum += raw;
+    if (++count < decimation)
+    {
+      return;
+    }
+
+    // Start from the first reading instead of ramping up from dark.
+    if (!primedFlag)
+    {
+      filtered = sum;
+      primedFlag = true;
+    }
+    filtered += (int16_t)(sum - filtered) >> filterShift;
+
+    sum = 0;
+    count = 0;
+  }
+
+  // 0 (dark) to 255 (bright).
+  uint8_t level()
+  {
+    uint16_t value;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+      value = filtered;
+    }
+    return value >> 6;
+  }
+
+private:
+  uint16_t sum = 0;
+  uint8_t count = 0;
+  bool primedFlag = false;
+  volatile uint16_t filtered = 0; // 16 x 10 bit ADC reading.
+};
+
+#if BOARD_HAS_LIGHT_SENSOR
+
+AmbientLight ambientLight;
+
+ISR(ADC_vect)
+{
+  ambientLight.addSample(ADC);
+}
+
+void SetupAmbientLight(uint8_t channel)
+{
+  ADMUX = _BV(REFS0) | (channel & 0x07); // AVcc reference.
+  DIDR0 |= _BV(channel & 0x07);          // No digital input buffer on the pin.
+  ADCSRB = 0;                            // Free running.
+  ADCSRA = _BV(ADEN) | _BV(ADSC) | _BV(ADATE) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+}
+
+#endif
@@ -0,0 +1,117 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "BoardProfile.h"
+#include "Log.h"
+
+// Timing probes, compiled in only for the benchmark build (-D BENCHMARK).
+// Each probe logs its average and worst case over a window of samples, as
+// the message given for the average and the message after it for the max.
+// micros() has a resolution of 8 us at 8 MHz, the average evens that out.
+
+#ifdef BENCHMARK
+
+#define BENCHMARK_WINDOW 256
+
+struct BenchmarkProbe
+{
+  uint8_t avgMessage;
+  unsigned long totalMicros;
+  unsigned long maxMicros;
+  unsigned int count;
+};
+
+void BenchmarkRecord(BenchmarkProbe &probe, unsigned long elapsedMicros)
+{
+  probe.totalMicros += elapsedMicros;
+  if (elapsedMicros > probe.maxMicros)
+  {
+    probe.maxMicros = elapsedMicros;
+  }
+
+  if (++probe.count == BENCHMARK_WINDOW)
+  {
+    LogWrite(probe.avgMessage, probe.totalMicros / BENCHMARK_WINDOW);
+    LogWrite(probe.avgMessage + 1, probe.maxMicros);
+    probe.totalMicros = 0;
+    probe.maxMicros = 0;
+    probe.count = 0;
+  }
+}
+
+#define BENCHMARK_PROBE(probe, avgMessage) BenchmarkProbe probe = {avgMessage, 0, 0, 0}
+#define BENCHMARK_BEGIN(probe) unsigned long probe##Start = micros()
+#define BENCHMARK_END(probe) BenchmarkRecord(probe, micros() - probe##Start)
+
+#else
+
+#define BENCHMARK_PROBE(probe, avgMessage)
+#define BENCHMARK_BEGIN(probe)
+#define BENCHMARK_END(probe)
+
+#endif
+
+// Interrupt latency, e.g. while strip.show() masks interrupts. Timer2 runs
+// in CTC mode at 4 us per count and interrupts every 1024 us. The counter
+// restarts at the compare match, so its value on entry to the ISR is how
+// long the interrupt waited. Delays over 1 ms wrap and read short. Timer2
+// belongs to the piezo on profiles that have one, so they go without.
+
+#if defined(BENCHMARK) && !BOARD_HAS_PIEZO
+
+#define BENCHMARK_LATENCY_WINDOW 1024
+
+volatile uint32_t latencyTotalCounts;
+volatile uint16_t latencyCount;
+volatile uint8_t latencyMaxCounts;
+
+ISR(TIMER2_COMPA_vect)
+{
+  uint8_t counts = TCNT2;
+  latencyTotalCounts += counts;
+  latencyCount++;
+  if (counts > latencyMaxCounts)
+  {
+    latencyMaxCounts = counts;
+  }
+}
+
+void BenchmarkLatencySetup()
+{
+  TCCR2A = _BV(WGM21);
+  TCCR2B = _BV(CS21) | _BV(CS20); // F_CPU / 32, 4 us at 8 MHz.
+  OCR2A = 255;
+  TIMSK2 |= _BV(OCIE2A);
+}
+
+// Logs the average and worst case once a window of samples is in.
+void BenchmarkLatencyReport()
+{
+  uint32_t total;
+  uint8_t maxCounts;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+  {
+    if (latencyCount < BENCHMARK_LATENCY_WINDOW)
+    {
+      return;
+    }
+    total = latencyTotalCounts;
+    maxCounts = latencyMaxCounts;
+    latencyTotalCounts = 0;
+    latencyMaxCounts = 0;
+    latencyCount = 0;
+  }
+
+  const uint8_t microsPerCount = 32 / clockCyclesPerMicrosecond();
+  LogWrite(LOG_BENCH_LATENCY_AVG, total * microsPerCount / BENCHMARK_LATENCY_WINDOW);
+  LogWrite(LOG_BENCH_LATENCY_MAX, maxCounts * microsPerCount);
+}
+
+#define BENCHMARK_LATENCY_SETUP() BenchmarkLatencySetup()
+#define BENCHMARK_LATENCY_REPORT() BenchmarkLatencyReport()
+
+#else
+
+#define BENCHMARK_LATENCY_SETUP()
+#define BENCHMARK_LATENCY_REPORT()
+
+#endif
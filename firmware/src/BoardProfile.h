@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stdint.h>
+#include "Zone.h" // Local
+
+// Compile-time board configuration. Everything the firmware needs to know
+// about the hardware lives in one profile, selected with -D BOARD_<NAME>.
+// Features a profile turns off compile out, and sizes are constants the
+// optimizer can unroll loops over.
+
+// ReMEDer2 as built: OLED menu, four buttons and a 7 pixel strip.
+struct ReMEDer2Board
+{
+  static const uint8_t pinButtonNext = 2;
+  static const uint8_t pinButtonPrev = 3;
+  static const uint8_t pinButtonSelect = 4;
+  static const uint8_t pinButtonReset = 7;
+  static const uint8_t pinLedResetButton = 5;
+  static const uint8_t pinLedStrip = 9;
+  static const uint8_t pinLedBuiltin = 13;
+  static const bool hasHeartbeatLed = true; // Blinks pinLedBuiltin.
+
+  static const uint8_t numPixels = 7;
+  // Strip segments, alarm n lights zone (n % number of zones).
+  static constexpr Zone zones[] = {{0, numPixels, FOLLOW_USER, FOLLOW_USER, FOLLOW_USER}};
+  static const bool ledStripOnSpi = false; // SpiNeoPixel instead of bit-banging.
+  static const uint8_t maxNumAlarms = 6;
+
+  static const bool hasDisplay = true;
+  static const uint8_t displayAddress = 0x3C;
+  static const uint8_t displayWidth = 128;
+  static const uint8_t displayHeight = 32;
+
+  static const bool hasRainbow = true;
+
+  static const bool hasPiezo = false;
+  static const uint8_t pinPiezo = 10; // Must be OC1B, see PiezoTone.h.
+
+  static const bool hasLightSensor = false;
+  static const uint8_t lightSensorChannel = 0; // A0
+  static const uint8_t minBrightnessCeiling = 24;
+
+  // Strip current limit, USB power minus the MCU and OLED. The estimate
+  // assumes each WS2812 channel draws milliampsPerChannel at full scale.
+  static const uint16_t currentBudgetMilliamps = 400;
+  static const uint8_t milliampsPerChannel = 20;
+  static const uint8_t idleMilliampsPerPixel = 1;
+
+  // Pattern step delays in milliseconds, by speed: slow, medium, fast.
+  static constexpr uint16_t FlashDelay(uint8_t speed) { return speed == 0 ? 2000 : speed == 1 ? 1000 : 500; }
+  static constexpr uint16_t SinwaveDelay(uint8_t speed) { return speed == 0 ? 10 : speed == 1 ? 5 : 1; }
+  static constexpr uint16_t StrobeDelay(uint8_t speed) { return speed == 0 ? 3000 : speed == 1 ? 1500 : 500; }
+  static constexpr uint16_t StrobeOnDelay() { return 250; }
+  static constexpr uint16_t SparkleDelay(uint8_t speed) { return speed == 0 ? 1000 : speed == 1 ? 500 : 200; }
+  static constexpr uint16_t ChaseDelay(uint8_t speed) { return speed == 0 ? 500 : speed == 1 ? 250 : 100; }
+  static constexpr uint16_t RainbowStepDelay() { return 50; }
+};
+
+// Indicator only: no OLED or menu buttons, alarms come from EEPROM.
+// Reset button and strip as on ReMEDer2, without the rainbow color.
+struct HeadlessBoard : ReMEDer2Board
+{
+  static const bool hasDisplay = false;
+  static const bool hasRainbow = false;
+};
+
+// ReMEDer2 with the strip data line moved to MOSI and driven by the SPI
+// hardware, see SpiNeoPixel.h.
+// The built-in LED is on SCK, so it can't be the heartbeat here.
+struct SpiStripBoard : ReMEDer2Board
+{
+  static const uint8_t pinLedStrip = 11;
+  static const bool ledStripOnSpi = true;
+  static const bool hasHeartbeatLed = false;
+};
+
+// ReMEDer2 with add-on hardware: a piezo on pin 10 and a light sensor on A0.
+struct ReMEDer2PlusBoard : ReMEDer2Board
+{
+  static const bool hasPiezo = true;
+  static const bool hasLightSensor = true;
+};
+
+// ReMEDer2 with the strip split in two zones, so alarms alternate between
+// the user's pattern on the first 4 pixels and a blue chase on the rest.
+struct TwoZoneBoard : ReMEDer2Board
+{
+  static constexpr Zone zones[] = {{0, 4, FOLLOW_USER, FOLLOW_USER, FOLLOW_USER}, {4, 3, BLUE, CHASE, FAST}};
+};
+
+// Definitions for the zone layouts, indexed at run time.
+constexpr Zone ReMEDer2Board::zones[];
+constexpr Zone TwoZoneBoard::zones[];
+
+#if defined(BOARD_HEADLESS)
+typedef HeadlessBoard Board;
+#elif defined(BOARD_SPI_STRIP)
+typedef SpiStripBoard Board;
+#elif defined(BOARD_TWO_ZONE)
+typedef TwoZoneBoard Board;
+#elif defined(BOARD_REMEDER2_PLUS)
+typedef ReMEDer2PlusBoard Board;
+#define BOARD_HAS_PIEZO 1
+#define BOARD_HAS_LIGHT_SENSOR 1
+#else
+typedef ReMEDer2Board Board;
+#endif
+
+// Features that own an interrupt vector are also switched with #if, so the
+// ISR is only linked into profiles with the hardware.
+#ifndef BOARD_HAS_PIEZO
+#define BOARD_HAS_PIEZO 0
+#endif
+#ifndef BOARD_HAS_LIGHT_SENSOR
+#define BOARD_HAS_LIGHT_SENSOR 0
+#endif
+static_assert(Board::hasPiezo == BOARD_HAS_PIEZO, "Set BOARD_HAS_PIEZO with the profile");
+static_assert(Board::hasLightSensor == BOARD_HAS_LIGHT_SENSOR, "Set BOARD_HAS_LIGHT_SENSOR with the profile");
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Non-blocking logging.
+//
+// Messages are IDs into a PROGMEM string table. By default each message is
+// sent as a 6 byte binary frame: 0xA5, ID, 32 bit value (little endian).
+// tools/logdecode.py turns the frames back into text. Build with -D LOG_TEXT
+// to print the strings on the device instead.
+//
+// Frames go into the HardwareSerial TX ring buffer, which the TX interrupt
+// drains. A message that does not fit in the free space is dropped instead
+// of stalling loop(), and the number dropped is reported with the next
+// message that fits.
+//
+// Levels above LOG_LEVEL compile to nothing, arguments included.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_FRAME_SYNC 0xA5
+#define LOG_FRAME_SIZE 6
+
+// Message table, read by tools/logdecode.py, keep one entry per line.
+// Text ending in ':' is followed by the message value.
+#define LOG_MESSAGES(X)                                                                \
+  X(LOG_DROPPED, "Log messages dropped:")                                              \
+  X(LOG_STARTUP, "ReMEDer starting up...")                                             \
+  X(LOG_RTC_COMMS_ERROR, "RTC communications error:")                                  \
+  X(LOG_RTC_LOST_CONFIDENCE, "RTC lost confidence in the DateTime!")                   \
+  X(LOG_RTC_WAS_STOPPED, "RTC was not actively running, starting now")                 \
+  X(LOG_RTC_OLDER_THAN_COMPILE, "RTC is older than compile time! (Updating DateTime)") \
+  X(LOG_RTC_SETUP_FINISHED, "RTC setup finished.")                                     \
+  X(LOG_TIME_SAVED, "Saving time data to RTC.")                                        \
+  X(LOG_DATE, "Date (yyyymmdd):")                                                      \
+  X(LOG_TIME, "Time (hhmmss):")                                                        \
+  X(LOG_DISPLAY_STARTED, "SSD1306 started.")                                           \
+  X(LOG_DISPLAY_NOT_RESPONDING, "SSD1306 not responding.")                             \
+  X(LOG_MISSED_THIS_WEEK, "Missed doses this week:")                                   \
+  X(LOG_MEAN_RESPONSE, "Mean response (min):")                                         \
+  X(LOG_FIRST_ALARM_CHECK_US, "Time to first alarm check us:")                         \
+  X(LOG_BENCH_OUTPUT_AVG, "Output pass avg us:")                                       \
+  X(LOG_BENCH_OUTPUT_MAX, "Output pass max us:")                                       \
+  X(LOG_BENCH_LOOP_AVG, "Loop avg us:")                                                \
+  X(LOG_BENCH_LOOP_MAX, "Loop max us:")                                                \
+  X(LOG_BENCH_SHOW_AVG, "Strip show avg us:")                                          \
+  X(LOG_BENCH_SHOW_MAX, "Strip show max us:")                                          \
+  X(LOG_BENCH_LATENCY_AVG, "Interrupt latency avg us:")                                \
+  X(LOG_BENCH_LATENCY_MAX, "Interrupt latency max us:")                                \
+  X(LOG_BENCH_TONE_1024_US, "Tone synth 1024 samples us:")                             \
+  X(LOG_BENCH_LIGHT_1024_US, "Light filter 1024 samples us:")                          \
+  X(LOG_STRIP_MILLIAMPS, "Strip current estimate mA:")
+
+#define LOG_ENUM(id, text) id,
+enum LogMessage
+{
+  LOG_MESSAGES(LOG_ENUM)
+};
+
+#define LOG_STRING(id, text) const char id##_TEXT[] PROGMEM = text;
+LOG_MESSAGES(LOG_STRING)
+
+#define LOG_TABLE(id, text) id##_TEXT,
+const char *const logStrings[] PROGMEM = {LOG_MESSAGES(LOG_TABLE)};
+
+unsigned int logDroppedCount;
+
+bool LogSend(uint8_t id, long value)
+{
+#ifdef LOG_TEXT
+  const char *text = (const char *)pgm_read_ptr(&logStrings[id]);
+  size_t length = strlen_P(text);
+  bool hasValue = pgm_read_byte(&text[length - 1]) == ':';
+  if (Serial.availableForWrite() < (int)length + (hasValue ? 13 : 2))
+  {
+    return false;
+  }
+
+  Serial.print((const __FlashStringHelper *)text);
+  if (hasValue)
+  {
+    Serial.print(' ');
+    Serial.print(value);
+  }
+  Serial.print('\n');
+#else
+  if (Serial.availableForWrite() < LOG_FRAME_SIZE)
+  {
+    return false;
+  }
+
+  uint8_t frame[LOG_FRAME_SIZE] = {LOG_FRAME_SYNC, id, (uint8_t)value, (uint8_t)(value >> 8), (uint8_t)(value >> 16), (uint8_t)(value >> 24)};
+  Serial.write(frame, LOG_FRAME_SIZE);
+#endif
+  return true;
+}
+
+void LogWrite(uint8_t id, long value = 0)
+{
+  if (logDroppedCount)
+  {
+    if (!LogSend(LOG_DROPPED, logDroppedCount))
+    {
+      logDroppedCount++;
+      return;
+    }
+    logDroppedCount = 0;
+  }
+
+  if (!LogSend(id, value))
+  {
+    logDroppedCount++;
+  }
+}
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LogWrite(__VA_ARGS__)
+#else
+#define LOG_ERROR(...) \
+  do                   \
+  {                    \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LogWrite(__VA_ARGS__)
+#else
+#define LOG_INFO(...) \
+  do                  \
+  {                   \
+  } while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LogWrite(__VA_ARGS__)
+#else
+#define LOG_DEBUG(...) \
+  do                   \
+  {                    \
+  } while (0)
+#endif
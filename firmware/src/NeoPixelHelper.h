@@ -23,3 +23,13 @@ uint32_t Wheel(byte WheelPos)
   WheelPos -= 170;
   return Color(WheelPos * 3, 255 - WheelPos * 3, 0);
 }
+
+// Scale each channel of a packed color, 255 leaves the color unchanged.
+uint32_t ScaleColor(uint32_t color, uint8_t scale)
+{
+  uint16_t s = scale + 1;
+  uint8_t r = ((uint8_t)(color >> 16) * s) >> 8;
+  uint8_t g = ((uint8_t)(color >> 8) * s) >> 8;
+  uint8_t b = ((uint8_t)color * s) >> 8;
+  return Color(r, g, b);
+}
@@ -0,0 +1,58 @@
+#include <Arduino.h>
+#include "BoardProfile.h"
+#include "ToneSynth.h"
+
+// Audible alarm on a piezo, synthesized from a PROGMEM wavetable.
+//
+// Timer2 interrupts at toneSampleRate and the ISR writes one sample from
+// ToneSynth::nextSample() into the Timer1 PWM duty on OC1B (pin 10), which
+// runs at 31.25 kHz as a crude DAC. nextSample() is a phase accumulator,
+// a table lookup and a linear envelope with no loops, so its cost per sample
+// is fixed. The synth itself is in ToneSynth.h, apart from the hardware.
+// The ISR and the timer setup are only compiled for profiles with
+// BOARD_HAS_PIEZO.
+
+#if BOARD_HAS_PIEZO
+
+ToneSynth toneSynth;
+
+ISR(TIMER2_COMPA_vect)
+{
+  OCR1B = toneSynth.nextSample();
+}
+
+void SetupPiezo(uint8_t pin)
+{
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, LOW);
+
+  // Timer1: 8 bit fast PWM, no prescaler, OC1B connected while playing.
+  TCCR1A = _BV(WGM10);
+  TCCR1B = _BV(WGM12) | _BV(CS10);
+
+  // Timer2: CTC at the sample rate, prescaler 8.
+  TCCR2A = _BV(WGM21);
+  TCCR2B = _BV(CS21);
+  OCR2A = F_CPU / 8 / toneSampleRate - 1;
+}
+
+void StartPiezo()
+{
+  if (toneSynth.playing())
+  {
+    return;
+  }
+  toneSynth.start(alarmMelody, sizeof(alarmMelody) / sizeof(alarmMelody[0]), toneSquare);
+  OCR1B = 128;
+  TCCR1A |= _BV(COM1B1);
+  TIMSK2 |= _BV(OCIE2A);
+}
+
+void StopPiezo()
+{
+  toneSynth.stop();
+  TIMSK2 &= ~_BV(OCIE2A);
+  TCCR1A &= ~_BV(COM1B1);
+}
+
+#endif
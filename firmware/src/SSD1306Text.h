@@ -0,0 +1,272 @@
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+
+// Classic 5 x 7 font, ASCII 0x20 to 0x7E, one byte per column (LSB on top).
+const uint8_t font5x7[] PROGMEM = {
+    0x00, 0x00, 0x00, 0x00, 0x00, //  
+    0x00, 0x00, 0x5F, 0x00, 0x00, // !
+    0x00, 0x07, 0x00, 0x07, 0x00, // "
+    0x14, 0x7F, 0x14, 0x7F, 0x14, // #
+    0x24, 0x2A, 0x7F, 0x2A, 0x12, // $
+    0x23, 0x13, 0x08, 0x64, 0x62, // %
+    0x36, 0x49, 0x55, 0x22, 0x50, // &
+    0x00, 0x05, 0x03, 0x00, 0x00, // '
+    0x00, 0x1C, 0x22, 0x41, 0x00, // (
+    0x00, 0x41, 0x22, 0x1C, 0x00, // )
+    0x08, 0x2A, 0x1C, 0x2A, 0x08, // *
+    0x08, 0x08, 0x3E, 0x08, 0x08, // +
+    0x00, 0x50, 0x30, 0x00, 0x00, // ,
+    0x08, 0x08, 0x08, 0x08, 0x08, // -
+    0x00, 0x60, 0x60, 0x00, 0x00, // .
+    0x20, 0x10, 0x08, 0x04, 0x02, // /
+    0x3E, 0x51, 0x49, 0x45, 0x3E, // 0
+    0x00, 0x42, 0x7F, 0x40, 0x00, // 1
+    0x42, 0x61, 0x51, 0x49, 0x46, // 2
+    0x21, 0x41, 0x45, 0x4B, 0x31, // 3
+    0x18, 0x14, 0x12, 0x7F, 0x10, // 4
+    0x27, 0x45, 0x45, 0x45, 0x39, // 5
+    0x3C, 0x4A, 0x49, 0x49, 0x30, // 6
+    0x01, 0x71, 0x09, 0x05, 0x03, // 7
+    0x36, 0x49, 0x49, 0x49, 0x36, // 8
+    0x06, 0x49, 0x49, 0x29, 0x1E, // 9
+    0x00, 0x36, 0x36, 0x00, 0x00, // :
+    0x00, 0x56, 0x36, 0x00, 0x00, // ;
+    0x00, 0x08, 0x14, 0x22, 0x41, // <
+    0x14, 0x14, 0x14, 0x14, 0x14, // =
+    0x41, 0x22, 0x14, 0x08, 0x00, // >
+    0x02, 0x01, 0x51, 0x09, 0x06, // ?
+    0x32, 0x49, 0x79, 0x41, 0x3E, // @
+    0x7E, 0x11, 0x11, 0x11, 0x7E, // A
+    0x7F, 0x49, 0x49, 0x49, 0x36, // B
+    0x3E, 0x41, 0x41, 0x41, 0x22, // C
+    0x7F, 0x41, 0x41, 0x22, 0x1C, // D
+    0x7F, 0x49, 0x49, 0x49, 0x41, // E
+    0x7F, 0x09, 0x09, 0x01, 0x01, // F
+    0x3E, 0x41, 0x41, 0x51, 0x32, // G
+    0x7F, 0x08, 0x08, 0x08, 0x7F, // H
+    0x00, 0x41, 0x7F, 0x41, 0x00, // I
+    0x20, 0x40, 0x41, 0x3F, 0x01, // J
+    0x7F, 0x08, 0x14, 0x22, 0x41, // K
+    0x7F, 0x40, 0x40, 0x40, 0x40, // L
+    0x7F, 0x02, 0x04, 0x02, 0x7F, // M
+    0x7F, 0x04, 0x08, 0x10, 0x7F, // N
+    0x3E, 0x41, 0x41, 0x41, 0x3E, // O
+    0x7F, 0x09, 0x09, 0x09, 0x06, // P
+    0x3E, 0x41, 0x51, 0x21, 0x5E, // Q
+    0x7F, 0x09, 0x19, 0x29, 0x46, // R
+    0x46, 0x49, 0x49, 0x49, 0x31, // S
+    0x01, 0x01, 0x7F, 0x01, 0x01, // T
+    0x3F, 0x40, 0x40, 0x40, 0x3F, // U
+    0x1F, 0x20, 0x40, 0x20, 0x1F, // V
+    0x7F, 0x20, 0x18, 0x20, 0x7F, // W
+    0x63, 0x14, 0x08, 0x14, 0x63, // X
+    0x03, 0x04, 0x78, 0x04, 0x03, // Y
+    0x61, 0x51, 0x49, 0x45, 0x43, // Z
+    0x00, 0x00, 0x7F, 0x41, 0x41, // [
+    0x02, 0x04, 0x08, 0x10, 0x20, // backslash
+    0x41, 0x41, 0x7F, 0x00, 0x00, // ]
+    0x04, 0x02, 0x01, 0x02, 0x04, // ^
+    0x40, 0x40, 0x40, 0x40, 0x40, // _
+    0x00, 0x01, 0x02, 0x04, 0x00, // `
+    0x20, 0x54, 0x54, 0x54, 0x78, // a
+    0x7F, 0x48, 0x44, 0x44, 0x38, // b
+    0x38, 0x44, 0x44, 0x44, 0x20, // c
+    0x38, 0x44, 0x44, 0x48, 0x7F, // d
+    0x38, 0x54, 0x54, 0x54, 0x18, // e
+    0x08, 0x7E, 0x09, 0x01, 0x02, // f
+    0x08, 0x14, 0x54, 0x54, 0x3C, // g
+    0x7F, 0x08, 0x04, 0x04, 0x78, // h
+    0x00, 0x44, 0x7D, 0x40, 0x00, // i
+    0x20, 0x40, 0x44, 0x3D, 0x00, // j
+    0x00, 0x7F, 0x10, 0x28, 0x44, // k
+    0x00, 0x41, 0x7F, 0x40, 0x00, // l
+    0x7C, 0x04, 0x18, 0x04, 0x78, // m
+    0x7C, 0x08, 0x04, 0x04, 0x78, // n
+    0x38, 0x44, 0x44, 0x44, 0x38, // o
+    0x7C, 0x14, 0x14, 0x14, 0x08, // p
+    0x08, 0x14, 0x14, 0x18, 0x7C, // q
+    0x7C, 0x08, 0x04, 0x04, 0x08, // r
+    0x48, 0x54, 0x54, 0x54, 0x20, // s
+    0x04, 0x3F, 0x44, 0x40, 0x20, // t
+    0x3C, 0x40, 0x40, 0x20, 0x7C, // u
+    0x1C, 0x20, 0x40, 0x20, 0x1C, // v
+    0x3C, 0x40, 0x30, 0x40, 0x3C, // w
+    0x44, 0x28, 0x10, 0x28, 0x44, // x
+    0x0C, 0x50, 0x50, 0x50, 0x3C, // y
+    0x44, 0x64, 0x54, 0x4C, 0x44, // z
+    0x00, 0x08, 0x36, 0x41, 0x00, // {
+    0x00, 0x00, 0x7F, 0x00, 0x00, // |
+    0x00, 0x41, 0x36, 0x08, 0x00, // }
+    0x08, 0x04, 0x08, 0x10, 0x08, // ~
+};
+
+// Doubles each bit of a nibble, used to stretch glyph columns to size 2.
+const uint8_t nibbleStretch[16] PROGMEM = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+
+const uint8_t ssd1306InitCommands[] PROGMEM = {
+    0xAE,       // Display off.
+    0xD5, 0x80, // Clock divide ratio.
+    0xD3, 0x00, // No display offset.
+    0x40,       // Start line 0.
+    0x8D, 0x14, // Internal charge pump on.
+    0x20, 0x00, // Horizontal addressing mode.
+    0xA1,       // Segment remap.
+    0xC8,       // COM scan direction, top down.
+    0x81, 0x8F, // Contrast.
+    0xD9, 0xF1, // Pre-charge period.
+    0xDB, 0x40, // VCOMH deselect level.
+    0xA4,       // Display follows RAM.
+    0xA6,       // Normal, not inverted.
+    0x2E};      // Scrolling off.
+
+// Text-only driver for a 128 x 32 or 128 x 64 SSD1306 OLED.
+// Renders size 2 glyphs (12 x 16 pixel cells, 10 columns by 2 rows on
+// 128 x 32) directly into the display pages from the PROGMEM font. There is
+// no framebuffer, only a copy of the characters on screen so unchanged
+// cells are skipped.
+template <uint8_t width, uint8_t height>
+class SSD1306Text
+{
+public:
+  static const uint8_t numCols = width / 12;
+  static const uint8_t numRows = height / 16;
+  static const uint8_t numPages = height / 8;
+
+  // Returns false if the display does not acknowledge its address.
+  bool begin(uint8_t i2cAddress)
+  {
+    address = i2cAddress;
+
+    Wire.begin();
+    Wire.beginTransmission(address);
+    if (Wire.endTransmission() != 0)
+    {
+      return false;
+    }
+
+    Wire.beginTransmission(address);
+    Wire.write(0x00); // Command stream.
+    for (uint8_t i = 0; i < sizeof(ssd1306InitCommands); i++)
+    {
+      Wire.write(pgm_read_byte(&ssd1306InitCommands[i]));
+    }
+    Wire.write(0xA8); // Multiplex ratio.
+    Wire.write(height - 1);
+    Wire.write(0xDA); // COM pins.
+    Wire.write(height == 64 ? 0x12 : 0x02);
+    Wire.write(SSD1306_DISPLAYON);
+    Wire.endTransmission();
+
+    clear();
+    return true;
+  }
+
+  void command(uint8_t c)
+  {
+    Wire.beginTransmission(address);
+    Wire.write(0x00);
+    Wire.write(c);
+    Wire.endTransmission();
+  }
+
+  void clear()
+  {
+    setWindow(0, width - 1, 0, numPages - 1);
+
+    // Display RAM is sent in chunks that fit the Wire buffer.
+    for (uint16_t chunk = 0; chunk < width * numPages / 16; chunk++)
+    {
+      Wire.beginTransmission(address);
+      Wire.write(0x40); // Data stream.
+      for (uint8_t i = 0; i < 16; i++)
+      {
+        Wire.write(0x00);
+      }
+      Wire.endTransmission();
+    }
+
+    memset(cells, ' ', sizeof(cells));
+  }
+
+  // Write a full row, padding with spaces so old text is erased.
+  void printRow(uint8_t row, const char *text)
+  {
+    for (uint8_t col = 0; col < numCols; col++)
+    {
+      char c = *text ? *text++ : ' ';
+      drawCell(col, row, c);
+    }
+  }
+
+  void printRow(uint8_t row, const __FlashStringHelper *text)
+  {
+    const char *p = reinterpret_cast<const char *>(text);
+    for (uint8_t col = 0; col < numCols; col++)
+    {
+      char c = pgm_read_byte(p);
+      if (c)
+      {
+        p++;
+      }
+      else
+      {
+        c = ' ';
+      }
+      drawCell(col, row, c);
+    }
+  }
+
+private:
+  void setWindow(uint8_t colStart, uint8_t colEnd, uint8_t pageStart, uint8_t pageEnd)
+  {
+    Wire.beginTransmission(address);
+    Wire.write(0x00);
+    Wire.write(0x21);
+    Wire.write(colStart);
+    Wire.write(colEnd);
+    Wire.write(0x22);
+    Wire.write(pageStart);
+    Wire.write(pageEnd);
+    Wire.endTransmission();
+  }
+
+  void drawCell(uint8_t col, uint8_t row, char c)
+  {
+    if (col >= numCols || row >= numRows || cells[row][col] == c)
+    {
+      return;
+    }
+    cells[row][col] = c;
+
+    if (c < 0x20 || c > 0x7E)
+    {
+      c = '?';
+    }
+    const uint8_t *glyph = &font5x7[(c - 0x20) * 5];
+
+    setWindow(col * 12, col * 12 + 11, row * 2, row * 2 + 1);
+
+    // Top page then bottom page, each glyph column doubled in width.
+    Wire.beginTransmission(address);
+    Wire.write(0x40);
+    for (uint8_t page = 0; page < 2; page++)
+    {
+      for (uint8_t x = 0; x < 6; x++)
+      {
+        uint8_t bits = x < 5 ? pgm_read_byte(&glyph[x]) : 0;
+        uint8_t stretched = pgm_read_byte(&nibbleStretch[page == 0 ? bits & 0x0F : bits >> 4]);
+        Wire.write(stretched);
+        Wire.write(stretched);
+      }
+    }
+    Wire.endTransmission();
+  }
+
+  uint8_t address;
+  char cells[numRows][numCols];
+};
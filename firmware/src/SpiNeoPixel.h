@@ -0,0 +1,94 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <util/atomic.h>
+
+// WS2812 output through the hardware SPI, as an alternative to the
+// bit-banged Adafruit_NeoPixel::show(). The strip data line must be on MOSI
+// (pin 11), the pin passed to the constructor is only kept for drop-in use.
+//
+// SPI runs at 4 MHz and every WS2812 bit becomes 4 SPI bits, 1000 for a 0
+// and 1110 for a 1, so each SPI byte carries two WS2812 bits. The shifting
+// is done by hardware and interrupts are only masked while the 4 SPI bytes
+// of one color byte go out (about 10 us), not for the whole frame.
+// Between color bytes the line idles low, which the strip reads as a longer
+// low phase. An interrupt served there must be shorter than the strip's
+// latch time.
+template <uint8_t numLeds>
+class SpiNeoPixel
+{
+public:
+  SpiNeoPixel(uint16_t n, int16_t pin, uint16_t type) {}
+
+  void begin()
+  {
+    SPI.begin();
+    memset(pixels, 0, sizeof(pixels));
+  }
+
+  void show()
+  {
+    // Hold the line low long enough for the previous frame to latch.
+    while (micros() - endMicros < 300)
+    {
+    }
+
+    SPI.beginTransaction(SPISettings(4000000, MSBFIRST, SPI_MODE0));
+    for (uint16_t i = 0; i < sizeof(pixels); i++)
+    {
+      uint8_t b = pixels[i];
+      ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+      {
+        SPI.transfer(pgm_read_byte(&bitPairs[b >> 6]));
+        SPI.transfer(pgm_read_byte(&bitPairs[(b >> 4) & 0x03]));
+        SPI.transfer(pgm_read_byte(&bitPairs[(b >> 2) & 0x03]));
+        SPI.transfer(pgm_read_byte(&bitPairs[b & 0x03]));
+      }
+    }
+    SPI.endTransaction();
+
+    endMicros = micros();
+  }
+
+  uint16_t numPixels() const
+  {
+    return numLeds;
+  }
+
+  // Pixels are stored in wire order, green, red, blue.
+  void setPixelColor(uint16_t n, uint32_t c)
+  {
+    if (n < numLeds)
+    {
+      pixels[n * 3] = c >> 8;
+      pixels[n * 3 + 1] = c >> 16;
+      pixels[n * 3 + 2] = c;
+    }
+  }
+
+  uint32_t getPixelColor(uint16_t n) const
+  {
+    if (n >= numLeds)
+    {
+      return 0;
+    }
+    return ((uint32_t)pixels[n * 3 + 1] << 16) | ((uint32_t)pixels[n * 3] << 8) | pixels[n * 3 + 2];
+  }
+
+  void fill(uint32_t c, uint16_t first, uint16_t count)
+  {
+    for (uint16_t i = first; i < first + count; i++)
+    {
+      setPixelColor(i, c);
+    }
+  }
+
+private:
+  // SPI byte for two WS2812 bits, indexed by the bit pair.
+  static const uint8_t bitPairs[4] PROGMEM;
+
+  uint8_t pixels[numLeds * 3];
+  unsigned long endMicros;
+};
+
+template <uint8_t numLeds>
+const uint8_t SpiNeoPixel<numLeds>::bitPairs[4] PROGMEM = {0x88, 0x8E, 0xE8, 0xEE};
@@ -0,0 +1,114 @@
+#include <stdint.h>
+
+// Wavetable synth for the piezo alarm, driven from the ISR in PiezoTone.h.
+// Free of Arduino and hardware calls so the sample stream can be captured
+// on the host, see test/tone_test.cpp.
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#elif !defined(pgm_read_byte)
+// Host build, flash and RAM share one address space.
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#endif
+
+const uint16_t toneSampleRate = 8000;
+
+// Phase accumulator step for a frequency in Hz.
+constexpr uint16_t ToneStep(uint16_t frequency)
+{
+  return (uint32_t)frequency * 65536 / toneSampleRate;
+}
+
+// One period of a sine, 32 signed samples.
+const int8_t toneSine[32] PROGMEM = {
+    0, 25, 49, 71, 90, 106, 117, 125, 127, 125, 117, 106, 90, 71, 49, 25,
+    0, -25, -49, -71, -90, -106, -117, -125, -127, -125, -117, -106, -90, -71, -49, -25};
+
+// Square with one step rounded, louder on a piezo than the sine.
+const int8_t toneSquare[32] PROGMEM = {
+    0, 90, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 90,
+    0, -90, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -127, -90};
+
+struct ToneNote
+{
+  uint16_t phaseStep; // 0 for a rest.
+  uint16_t samples;
+};
+
+// Repeated while the alarm is on: two short beeps and a pause.
+const ToneNote alarmMelody[] PROGMEM = {
+    {ToneStep(1500), 800},
+    {0, 800},
+    {ToneStep(1500), 800},
+    {0, 5600}};
+
+class ToneSynth
+{
+public:
+  // Envelope rise and fall per sample, about 2 ms and 1 ms at 8 kHz, so
+  // notes start and end without clicks.
+  static const uint8_t attackStep = 16;
+  static const uint8_t releaseStep = 32;
+  static const uint8_t releaseSamples = 8;
+
+  void start(const ToneNote *notes, uint8_t count, const int8_t *waveform)
+  {
+    melody = notes;
+    numNotes = count;
+    wave = waveform;
+    noteIndex = count - 1;
+    samplesLeft = 0;
+    phase = 0;
+    envelope = 0;
+    playingFlag = true;
+  }
+
+  void stop()
+  {
+    playingFlag = false;
+  }
+
+  bool playing()
+  {
+    return playingFlag;
+  }
+
+  // Next PWM duty, 128 is silence.
+  uint8_t nextSample()
+  {
+    if (samplesLeft == 0)
+    {
+      noteIndex = noteIndex + 1 == numNotes ? 0 : noteIndex + 1;
+      step = pgm_read_word(&melody[noteIndex].phaseStep);
+      samplesLeft = pgm_read_word(&melody[noteIndex].samples);
+    }
+    samplesLeft--;
+
+    // Rise while the note sounds, fall at its end and during rests.
+    if (step != 0 && samplesLeft > releaseSamples)
+    {
+      envelope = envelope > 255 - attackStep ? 255 : envelope + attackStep;
+    }
+    else
+    {
+      envelope = envelope < releaseStep ? 0 : envelope - releaseStep;
+    }
+
+    phase += step;
+    int8_t sample = pgm_read_byte(&wave[phase >> 11]);
+    return 128 + ((sample * envelope) >> 8);
+  }
+
+private:
+  const ToneNote *melody;
+  const int8_t *wave;
+  uint8_t numNotes;
+  uint8_t noteIndex;
+  uint16_t samplesLeft;
+  uint16_t phase;
+  uint16_t step;
+  uint8_t envelope;
+  bool playingFlag;
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+
+// Indicator settings, shared by the menu and the board zone layouts.
+
+enum Colors
+{
+  RED,
+  GREEN,
+  BLUE,
+  RANDOM,
+  RAINBOW,
+  MAX_COLOR
+};
+
+enum Patterns
+{
+  FLASH,
+  SINWAVE,
+  STROBE,
+  SPARKLE,
+  CHASE,
+  MAX_PATTERN
+};
+
+enum Speeds
+{
+  SLOW,
+  MEDIUM,
+  FAST,
+  MAX_SPEED
+};
+
+// A segment of the strip with its own pattern. Color, pattern and speed
+// may be fixed per zone or follow the user settings.
+#define FOLLOW_USER -1
+struct Zone
+{
+  uint8_t firstPixel;
+  uint8_t numPixels;
+  int color;
+  int pattern;
+  int speed;
+};
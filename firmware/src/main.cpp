@@ -19,46 +19,60 @@
 #include <SPI.h>
 #include <Wire.h>
 #include <RtcDS1307.h> // RTC Library: https://github.com/Makuna/Rtc
-#include <Adafruit_I2CDevice.h>
-#include <Adafruit_GFX.h>
-#include <Adafruit_SSD1306.h>
 #include <EEPROM.h>
 #include <Adafruit_NeoPixel.h>
 #include <JC_Button.h>      // https://github.com/JChristensen/JC_Button
+#include "BoardProfile.h"   // Local
 #include "NeoPixelHelper.h" // Local
-
-#define PIN_BUTTON_NEXT 2
-#define PIN_BUTTON_PREV 3
-#define PIN_BUTTON_SELECT 4
-#define PIN_BUTTON_RESET 7
-#define PIN_LED_RESET_BUTTON 5
-#define PIN_LED_STRIP 9
-#define PIN_LED_BUILTIN 13
+#include "SpiNeoPixel.h"    // Local
+#include "AlarmHelper.h"    // Local
+#include "SSD1306Text.h"    // Local
+#include "Log.h"            // Local
+#include "Benchmark.h"      // Local
+#include "AdherenceLog.h"   // Local
+#include "PiezoTone.h"      // Local
+#include "AmbientLight.h"   // Local
 
 const int selectedItemFlash = 500;
 
 RtcDS1307<TwoWire> Rtc(Wire);
 
-#define SCREEN_WIDTH 128 // OLED display width, in pixels
-#define SCREEN_HEIGHT 32 // OLED display height, in pixels
-#define OLED_RESET -1    // Reset pin # (or -1 if sharing Arduino reset pin)
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+// RTC conditions found during setup, reported once Serial output starts.
+#define RTC_LOST_CONFIDENCE 0x01
+#define RTC_WAS_STOPPED 0x02
+#define RTC_OLDER_THAN_COMPILE 0x04
+byte rtcSetupFlags;
+
+SSD1306Text<Board::displayWidth, Board::displayHeight> display;
+bool displayReadyFlag = false; // Set once the OLED answers after power up.
+bool displayFailedFlag = false; // Set if it never answers, the unit then runs headless.
+const int displayReadyTimeout = 2000;
 const int numSpacesLCD = 9;
-bool displayOnFlag = true;
+bool displayOnFlag = false; // Off until a button press, the indicator shows first.
 
-Button buttonReset(PIN_BUTTON_RESET);
-Button buttonSelect(PIN_BUTTON_SELECT);
-Button buttonPrev(PIN_BUTTON_PREV);
-Button buttonNext(PIN_BUTTON_NEXT);
+Button buttonReset(Board::pinButtonReset);
+Button buttonSelect(Board::pinButtonSelect);
+Button buttonPrev(Board::pinButtonPrev);
+Button buttonNext(Board::pinButtonNext);
 
-const int numPixels = 7;
-Adafruit_NeoPixel strip = Adafruit_NeoPixel(numPixels, PIN_LED_STRIP, NEO_GRB + NEO_KHZ800);
+// Strip driver picked by the board profile.
+template <bool onSpi>
+struct StripDriver
+{
+  typedef Adafruit_NeoPixel type;
+};
+template <>
+struct StripDriver<true>
+{
+  typedef SpiNeoPixel<Board::numPixels> type;
+};
+StripDriver<Board::ledStripOnSpi>::type strip(Board::numPixels, Board::pinLedStrip, NEO_GRB + NEO_KHZ800);
 
 #define countof(a) (sizeof(a) / sizeof(a[0]))
 
 int timeHour, timeMinute, alarmHour, alarmMinute;
+uint32_t nowSeconds; // RTC time, seconds since 2000.
 bool indicatorOn = false;
-bool newRandomColorFlag;
 
 enum Menu
 {
@@ -70,48 +84,20 @@ enum Menu
   COLOR,
   PATTERN,
   SPEED,
+  HISTORY,
   MAX_MENUITEM
 };
 int selectedMenuItem = TIME_HOUR;
 
-const int maxNumAlarms = 6;
 int selectedAlarm;
-struct Alarm
-{
-  byte hour;
-  byte minute;
-};
+AlarmClock alarmClock;
 
+// Menu text for the settings in Zone.h.
 const char *colorText[5] = {"Red", "Green", "Blue", "Random", "Rainbow"};
-enum Colors
-{
-  RED,
-  GREEN,
-  BLUE,
-  RANDOM,
-  RAINBOW,
-  MAX_COLOR
-};
+const int numColors = Board::hasRainbow ? MAX_COLOR : RAINBOW;
 
 const char *patternText[5] = {"Flash", "Sinwave", "Strobe", "Sparkle", "Chase"};
-enum Patterns
-{
-  FLASH,
-  SINWAVE,
-  STROBE,
-  SPARKLE,
-  CHASE,
-  MAX_PATTERN
-};
-
 const char *speedText[5] = {"Slow", "Medium", "Fast"};
-enum Speeds
-{
-  SLOW,
-  MEDIUM,
-  FAST,
-  MAX_SPEED
-};
 
 //
 struct UserParams
@@ -120,180 +106,374 @@ struct UserParams
   int pattern;
   int speed;
   int numAlarms;
-  Alarm alarms[maxNumAlarms];
+  Alarm alarms[Board::maxNumAlarms];
 } userParams;
 
+// Pattern state of a zone, advanced by ProcessZone().
+struct ZoneState
+{
+  unsigned long lastMillis;
+  unsigned long lastColorMillis;
+  bool toggleFlag;
+  bool newRandomColorFlag;
+  int sinValue;
+  byte index;
+  byte wheelPos;
+};
+
+// Alarm n lights zone (n % numZones). All zones are segments of the one
+// strip and are sent out together by a single strip.show(). The layout is
+// in the board profile and constant, so each zone's loops have compile-time
+// bounds.
+const int numZones = countof(Board::zones);
+static_assert(numZones <= 8, "Zone bits do not fit in a byte");
+ZoneState zoneStates[numZones];
+const byte allZones = (1 << numZones) - 1;
+byte activeZones; // Bit per zone lit by an alarm.
+
+constexpr bool ZonesOnStrip(int zoneIndex)
+{
+  return zoneIndex == numZones ||
+         (Board::zones[zoneIndex].firstPixel + Board::zones[zoneIndex].numPixels <= Board::numPixels &&
+          ZonesOnStrip(zoneIndex + 1));
+}
+static_assert(ZonesOnStrip(0), "Zone past the end of the strip");
+
+// Crossfade from the outgoing frame when the color, pattern or lit zones
+// change. Only the outgoing frame is kept, the incoming one is the strip.
+const unsigned int fadeMillis = 400;
+byte fadeFromFrame[Board::numPixels * 3];
+uint32_t fadeFromSum; // Sum of the channels in fadeFromFrame.
+unsigned long fadeStartMillis;
+bool fadeActiveFlag;
+
+// Current limit, see ProcessOutput().
+const uint16_t channelBudgetMilliamps = Board::currentBudgetMilliamps - Board::numPixels * Board::idleMilliampsPerPixel;
+static_assert(Board::currentBudgetMilliamps > Board::numPixels * Board::idleMilliampsPerPixel, "Current budget below the strip's idle draw");
+uint32_t frameChannelSum; // Summed by ProcessZone() as it draws the frame.
+uint16_t stripMilliamps;  // Estimate for the last frame shown.
+
+BENCHMARK_PROBE(outputProbe, LOG_BENCH_OUTPUT_AVG);
+BENCHMARK_PROBE(loopProbe, LOG_BENCH_LOOP_AVG);
+BENCHMARK_PROBE(showProbe, LOG_BENCH_SHOW_AVG);
+
+// EEPROM layout: UserParams at 0, adherence log of 2 byte records after it.
+// Log records hold the alarm index in 3 bits, with 7 marking an empty slot.
+#define EEPROM_ADHERENCE_LOG 64
+static_assert(sizeof(UserParams) <= EEPROM_ADHERENCE_LOG, "UserParams overlaps the adherence log");
+static_assert(Board::maxNumAlarms <= 7, "Alarm index does not fit in an adherence log record");
+AdherenceLog adherenceLog(EEPROM_ADHERENCE_LOG, 128);
+
 ///////////////////////////////////////////////////////////////////////////////
 
+// False on boards without the OLED and once it failed to answer.
+bool DisplayPresent()
+{
+  return Board::hasDisplay && !displayFailedFlag;
+}
+
 void Error()
 {
   // Loop forever, indicates fatal error.
   while (1)
   {
-    analogWrite(PIN_LED_RESET_BUTTON, 0);
+    analogWrite(Board::pinLedResetButton, 0);
     delay(500);
-    analogWrite(PIN_LED_RESET_BUTTON, 127);
+    analogWrite(Board::pinLedResetButton, 127);
     delay(100);
   }
 }
 
-void SetFullStripToColor()
+void ResetZoneState(ZoneState &state)
 {
-  if (userParams.color == RED)
+  state = ZoneState();
+  state.lastMillis = millis();
+  state.lastColorMillis = millis();
+  state.toggleFlag = true;
+}
+
+uint32_t GetZonePixelColor(const Zone &zone, ZoneState &state, int color, byte pixel)
+{
+  if (color == RED)
   {
-    strip.fill(strip.Color(255, 0, 0), 0, strip.numPixels());
+    return Color(255, 0, 0);
   }
-  else if (userParams.color == GREEN)
+  else if (color == GREEN)
   {
-    strip.fill(strip.Color(0, 255, 0), 0, strip.numPixels());
+    return Color(0, 255, 0);
   }
-  else if (userParams.color == BLUE)
+  else if (color == BLUE)
   {
-    strip.fill(strip.Color(0, 0, 255), 0, strip.numPixels());
+    return Color(0, 0, 255);
   }
-  else if (userParams.color == RANDOM)
+  else if (color == RANDOM)
   {
-    static byte wheelPos = 0;
-    if (newRandomColorFlag)
-    {
-      newRandomColorFlag = false;
-      wheelPos = random(0, 256);
-    }
-    strip.fill(Wheel(wheelPos), 0, strip.numPixels());
+    return Wheel(state.wheelPos);
   }
-  else if (userParams.color == RAINBOW)
+  else if (Board::hasRainbow && color == RAINBOW)
   {
-    static byte wheelPos = 0;
-    static unsigned long last = millis();
-    if (millis() - last > 50)
-    {
-      last = millis();
-      wheelPos++;
-    }
-
-    for (unsigned int i = 0; i < strip.numPixels(); i++)
-    {
-      strip.setPixelColor(i, Wheel(wheelPos + i * (255 / strip.numPixels())));
-    }
+    return Wheel(state.wheelPos + pixel * (255 / zone.numPixels));
   }
+  return 0;
 }
 
-void ProcessIndicator(bool indicatorOn)
+template <int zoneIndex>
+void ProcessZone(bool zoneOn)
 {
-  if (!indicatorOn)
+  constexpr Zone zone = Board::zones[zoneIndex];
+  ZoneState &state = zoneStates[zoneIndex];
+
+  if (!zoneOn)
   {
-    strip.fill(strip.Color(0, 0, 0), 0, strip.numPixels());
-    strip.show();
+    strip.fill(Color(0, 0, 0), zone.firstPixel, zone.numPixels);
     return;
   }
 
-  SetFullStripToColor();
+  int color = zone.color == FOLLOW_USER ? userParams.color : zone.color;
+  int pattern = zone.pattern == FOLLOW_USER ? userParams.pattern : zone.pattern;
+  int speed = zone.speed == FOLLOW_USER ? userParams.speed : zone.speed;
 
-  if (userParams.pattern == FLASH)
-  {
-    static bool toggleFlag = true;
-    static unsigned long last = millis();
+  byte brightness = 255;
+  bool singlePixel = false;
 
-    unsigned int delay = userParams.speed == 0 ? 2000 : userParams.speed == 1 ? 1000
-                                                    : userParams.speed == 2   ? 500
-                                                                              : 100;
-    if (millis() - last > delay)
+  if (pattern == FLASH)
+  {
+    unsigned int delay = Board::FlashDelay(speed);
+    if (millis() - state.lastMillis > delay)
     {
-      last = millis();
-      toggleFlag = !toggleFlag;
-      newRandomColorFlag = true;
+      state.lastMillis = millis();
+      state.toggleFlag = !state.toggleFlag;
+      state.newRandomColorFlag = true;
     }
-    strip.setBrightness(toggleFlag ? 255 : 0);
+    brightness = state.toggleFlag ? 255 : 0;
   }
-  else if (userParams.pattern == SINWAVE)
+  else if (pattern == SINWAVE)
   {
-    static int sinValue = 0;
-    static unsigned long last = millis();
-
-    unsigned int delay = userParams.speed == 0 ? 10 : userParams.speed == 1 ? 5
-                                                  : userParams.speed == 2   ? 1
-                                                                            : 0;
-    if (millis() - last > delay)
+    unsigned int delay = Board::SinwaveDelay(speed);
+    if (millis() - state.lastMillis > delay)
     {
-      last = millis();
+      state.lastMillis = millis();
 
-      sinValue++;
-      if (sinValue == 361)
+      state.sinValue++;
+      if (state.sinValue == 361)
       {
-        sinValue = 0;
+        state.sinValue = 0;
       }
-      if (sinValue == 180)
+      if (state.sinValue == 180)
       {
-        newRandomColorFlag = true;
+        state.newRandomColorFlag = true;
       }
     }
-    strip.setBrightness((255 / 2) + (255 / 2) * sin(radians(sinValue)));
+    brightness = (255 / 2) + (255 / 2) * sin(radians(state.sinValue));
   }
-  else if (userParams.pattern == STROBE)
+  else if (pattern == STROBE)
   {
-    static unsigned long last = millis();
-    static bool toggleFlag = true;
+    unsigned int delay = Board::StrobeDelay(speed);
+    unsigned int strobeDelay = state.toggleFlag ? Board::StrobeOnDelay() : delay;
+    if (millis() - state.lastMillis > strobeDelay)
+    {
+      state.lastMillis = millis();
+      state.newRandomColorFlag = true;
+      state.toggleFlag = !state.toggleFlag;
+    }
+    brightness = state.toggleFlag ? 255 : 0;
+  }
+  else if (pattern == SPARKLE)
+  {
+    unsigned int delay = Board::SparkleDelay(speed);
+    if (millis() - state.lastMillis > delay)
+    {
+      state.lastMillis = millis();
+      state.newRandomColorFlag = true;
+      state.index = random(0, zone.numPixels);
+    }
+    singlePixel = true;
+  }
+  else if (pattern == CHASE)
+  {
+    unsigned int delay = Board::ChaseDelay(speed);
+    if (millis() - state.lastMillis > delay)
+    {
+      state.lastMillis = millis();
+      state.newRandomColorFlag = true;
+      state.index++;
+      if (state.index >= zone.numPixels)
+      {
+        state.index = 0;
+      }
+    }
+    singlePixel = true;
+  }
 
-    unsigned int delay = userParams.speed == 0 ? 3000 : userParams.speed == 1 ? 1500
-                                                    : userParams.speed == 2   ? 500
-                                                                              : 100;
-    unsigned int strobeDelay = toggleFlag ? 250 : delay;
-    if (millis() - last > strobeDelay)
+  if (color == RANDOM && state.newRandomColorFlag)
+  {
+    state.newRandomColorFlag = false;
+    state.wheelPos = random(0, 256);
+  }
+  else if (Board::hasRainbow && color == RAINBOW && millis() - state.lastColorMillis > Board::RainbowStepDelay())
+  {
+    state.lastColorMillis = millis();
+    state.wheelPos++;
+  }
+
+  for (byte i = 0; i < zone.numPixels; i++)
+  {
+    uint32_t pixelColor = 0;
+    if (!singlePixel || i == state.index)
     {
-      last = millis();
-      newRandomColorFlag = true;
-      toggleFlag = !toggleFlag;
+      pixelColor = ScaleColor(GetZonePixelColor(zone, state, color, i), brightness);
     }
-    strip.setBrightness(toggleFlag ? 255 : 0);
+    strip.setPixelColor(zone.firstPixel + i, pixelColor);
+    frameChannelSum += (uint8_t)(pixelColor >> 16) + (uint8_t)(pixelColor >> 8) + (uint8_t)pixelColor;
   }
-  else if (userParams.pattern == SPARKLE)
+}
+
+// Runs ProcessZone() for each zone, unrolled at compile time.
+template <int zoneIndex>
+void ProcessZones(byte litZones)
+{
+  ProcessZone<zoneIndex>(litZones & (1 << zoneIndex));
+  ProcessZones<zoneIndex + 1>(litZones);
+}
+
+template <>
+void ProcessZones<numZones>(byte litZones)
+{
+}
+
+void StartFade()
+{
+  fadeFromSum = 0;
+  for (int i = 0; i < Board::numPixels; i++)
   {
-    static byte index = 0;
-    static unsigned long last = millis();
+    uint32_t c = strip.getPixelColor(i);
+    fadeFromFrame[i * 3] = c >> 16;
+    fadeFromFrame[i * 3 + 1] = c >> 8;
+    fadeFromFrame[i * 3 + 2] = c;
+    fadeFromSum += fadeFromFrame[i * 3] + fadeFromFrame[i * 3 + 1] + fadeFromFrame[i * 3 + 2];
+  }
+  fadeStartMillis = millis();
+  fadeActiveFlag = true;
+}
 
-    unsigned int delay = userParams.speed == 0 ? 1000 : userParams.speed == 1 ? 500
-                                                    : userParams.speed == 2   ? 200
-                                                                              : 200;
-    if (millis() - last > delay)
+// Final pass over the frame before it is shown. Scales the new frame to the
+// ambient light brightness ceiling, then blends the outgoing frame over it
+// with an 8 bit fixed point lerp. The outgoing frame was already scaled.
+//
+// The same pass scales the frame to the current budget. ProcessZone() sums
+// the channels as it draws, so the current of the blended frame is known
+// before the pass and the frame that would exceed the budget is the one
+// scaled down.
+void ProcessOutput()
+{
+  uint8_t ceiling = 255;
+#if BOARD_HAS_LIGHT_SENSOR
+  // Rounded up so full daylight is no ceiling at all and the pass is skipped.
+  ceiling = Board::minBrightnessCeiling + ((uint16_t)ambientLight.level() * (255 - Board::minBrightnessCeiling) + 254) / 255;
+#endif
+
+  uint16_t alpha = 256; // 256 is no fade.
+  if (fadeActiveFlag)
+  {
+    unsigned long elapsed = millis() - fadeStartMillis;
+    if (elapsed >= fadeMillis)
     {
-      last = millis();
-      newRandomColorFlag = true;
-      index = random(0, strip.numPixels());
+      fadeActiveFlag = false;
     }
-    strip.setBrightness(255);
-    for (unsigned int i = 0; i < strip.numPixels(); i++)
+    else
     {
-      if (i != index)
-        strip.setPixelColor(i, strip.Color(0, 0, 0));
+      alpha = (elapsed << 8) / fadeMillis; // 0 to 255
     }
   }
-  else if (userParams.pattern == CHASE)
+
+  // Channel sum of the frame leaving the pass, before the limit. Rounding
+  // in the pass only makes the real sum smaller.
+  uint16_t scale = ceiling + 1;
+  uint16_t inverse = 256 - alpha;
+  uint32_t channelSum = (frameChannelSum * scale) >> 8;
+  if (alpha != 256)
   {
-    static byte index = 0;
-    static unsigned long last = millis();
+    channelSum = (fadeFromSum * inverse + channelSum * alpha) >> 8;
+  }
 
-    unsigned int delay = userParams.speed == 0 ? 500 : userParams.speed == 1 ? 250
-                                                   : userParams.speed == 2   ? 100
-                                                                             : 100;
-    if (millis() - last > delay)
+  uint16_t channelMilliamps = channelSum * Board::milliampsPerChannel / 255;
+  uint16_t limitScale = 256; // 256 is no limit.
+  if (channelMilliamps > channelBudgetMilliamps)
+  {
+    limitScale = ((uint32_t)channelBudgetMilliamps << 8) / channelMilliamps;
+    channelMilliamps = ((uint32_t)channelMilliamps * limitScale) >> 8;
+  }
+  stripMilliamps = channelMilliamps + Board::numPixels * Board::idleMilliampsPerPixel;
+
+  if (scale == 256 && alpha == 256 && limitScale == 256)
+  {
+    return;
+  }
+
+  BENCHMARK_BEGIN(outputProbe);
+
+  for (int i = 0; i < Board::numPixels; i++)
+  {
+    uint32_t c = strip.getPixelColor(i);
+    uint8_t r = ((uint8_t)(c >> 16) * scale) >> 8;
+    uint8_t g = ((uint8_t)(c >> 8) * scale) >> 8;
+    uint8_t b = ((uint8_t)c * scale) >> 8;
+    if (alpha != 256)
     {
-      last = millis();
-      newRandomColorFlag = true;
-      index++;
-      if (index >= strip.numPixels())
-      {
-        index = 0;
-      }
+      r = (fadeFromFrame[i * 3] * inverse + r * alpha) >> 8;
+      g = (fadeFromFrame[i * 3 + 1] * inverse + g * alpha) >> 8;
+      b = (fadeFromFrame[i * 3 + 2] * inverse + b * alpha) >> 8;
+    }
+    if (limitScale != 256)
+    {
+      r = (r * limitScale) >> 8;
+      g = (g * limitScale) >> 8;
+      b = (b * limitScale) >> 8;
     }
-    strip.setBrightness(255);
-    for (unsigned int i = 0; i < strip.numPixels(); i++)
+    strip.setPixelColor(i, Color(r, g, b));
+  }
+
+  BENCHMARK_END(outputProbe);
+}
+
+// Light the zones set in zoneMask, all others are turned off.
+void ProcessIndicator(bool indicatorOn, byte zoneMask)
+{
+  static int lastColor = -1;
+  static int lastPattern = -1;
+  static byte lastLitZones;
+
+  // Fade into any change, restarting patterns that follow the user settings.
+  byte litZones = indicatorOn ? zoneMask : 0;
+  bool settingsChanged = userParams.color != lastColor || userParams.pattern != lastPattern;
+  if (settingsChanged || litZones != lastLitZones)
+  {
+    StartFade();
+
+    if (settingsChanged)
     {
-      if (i != index)
-        strip.setPixelColor(i, strip.Color(0, 0, 0));
+      for (int i = 0; i < numZones; i++)
+      {
+        if (Board::zones[i].color == FOLLOW_USER || Board::zones[i].pattern == FOLLOW_USER)
+        {
+          ResetZoneState(zoneStates[i]);
+        }
+      }
     }
+
+    lastColor = userParams.color;
+    lastPattern = userParams.pattern;
+    lastLitZones = litZones;
   }
 
+  frameChannelSum = 0;
+  ProcessZones<0>(litZones);
+
+  ProcessOutput();
+
+  BENCHMARK_BEGIN(showProbe);
   strip.show();
+  BENCHMARK_END(showProbe);
 }
 
 bool ProcessResetButton()
@@ -384,7 +564,7 @@ bool ProcessControlButtons()
     {
       if (userParams.numAlarms == 1)
       {
-        userParams.numAlarms = maxNumAlarms;
+        userParams.numAlarms = Board::maxNumAlarms;
       }
       else
       {
@@ -417,7 +597,7 @@ bool ProcessControlButtons()
     {
       if (userParams.color == 0)
       {
-        userParams.color = MAX_COLOR - 1;
+        userParams.color = numColors - 1;
       }
       else
       {
@@ -477,7 +657,7 @@ bool ProcessControlButtons()
     else if (selectedMenuItem == NUMALARMS)
     {
       userParams.numAlarms++;
-      if (userParams.numAlarms >= maxNumAlarms)
+      if (userParams.numAlarms > Board::maxNumAlarms)
       {
         userParams.numAlarms = 1;
       }
@@ -485,7 +665,7 @@ bool ProcessControlButtons()
     else if (selectedMenuItem == ALARM_HOUR)
     {
       userParams.alarms[selectedAlarm - 1].hour++;
-      if (userParams.alarms[selectedAlarm - 1].hour > 59)
+      if (userParams.alarms[selectedAlarm - 1].hour > 23)
       {
         userParams.alarms[selectedAlarm - 1].hour = 0;
       }
@@ -501,7 +681,7 @@ bool ProcessControlButtons()
     else if (selectedMenuItem == COLOR)
     {
       userParams.color++;
-      if (userParams.color >= MAX_PATTERN)
+      if (userParams.color >= numColors)
       {
         userParams.color = 0;
       }
@@ -553,49 +733,43 @@ void UpdateDisplay(bool updateFlag)
   }
 
   // Only update when there is new data or the data is to be flashed.
+  // Unchanged characters are skipped by the display driver.
   if (updateFlag)
   {
-    display.setTextSize(2);
-    display.setTextColor(SSD1306_WHITE, SSD1306_BLACK);
-
-    // Update entire display when new menu item is selected.
     // Display first row.
-    static bool selectedMenuItemBuffer = 99; // Force refresh upon startup.
-    if (selectedMenuItemBuffer != selectedMenuItem)
+    if (selectedMenuItem == TIME_HOUR || selectedMenuItem == TIME_MIN)
     {
-      selectedMenuItemBuffer = selectedMenuItem;
-      display.clearDisplay();
-      display.setCursor(0, 0);
-
-      if (selectedMenuItem == TIME_HOUR || selectedMenuItem == TIME_MIN)
-      {
-        display.println(F("Time"));
-      }
-      else if (selectedMenuItem == NUMALARMS)
-      {
-        display.println(F("No. Alarms"));
-      }
-      else if (selectedMenuItem == ALARM_HOUR || selectedMenuItem == ALARM_MIN)
-      {
-        sprintf(buf, "Alarm: %u", selectedAlarm);
-        display.println(buf);
-      }
-      else if (selectedMenuItem == COLOR)
-      {
-        display.println(F("Color"));
-      }
-      else if (selectedMenuItem == PATTERN)
-      {
-        display.println(F("Pattern"));
-      }
-      else if (selectedMenuItem == SPEED)
-      {
-        display.println(F("Speed"));
-      }
+      display.printRow(0, F("Time"));
+    }
+    else if (selectedMenuItem == NUMALARMS)
+    {
+      display.printRow(0, F("No. Alarms"));
+    }
+    else if (selectedMenuItem == ALARM_HOUR || selectedMenuItem == ALARM_MIN)
+    {
+      sprintf(buf, "Alarm: %u", selectedAlarm);
+      display.printRow(0, buf);
+    }
+    else if (selectedMenuItem == COLOR)
+    {
+      display.printRow(0, F("Color"));
+    }
+    else if (selectedMenuItem == PATTERN)
+    {
+      display.printRow(0, F("Pattern"));
+    }
+    else if (selectedMenuItem == SPEED)
+    {
+      display.printRow(0, F("Speed"));
+    }
+    else if (selectedMenuItem == HISTORY)
+    {
+      sprintf(buf, "Missed: %u", adherenceLog.missedThisWeek(nowSeconds / 86400));
+      display.printRow(0, buf);
     }
 
     // Display second row.
-    display.setCursor(0, 16);
+    buf[0] = '\0';
 
     if (selectedMenuItem == TIME_HOUR)
     {
@@ -604,7 +778,7 @@ void UpdateDisplay(bool updateFlag)
       else
         sprintf(buf, "  :%02u", timeMinute);
     }
-    if (selectedMenuItem == TIME_MIN)
+    else if (selectedMenuItem == TIME_MIN)
     {
       if (displayValue)
         sprintf(buf, "%02u:%02u", timeHour, timeMinute);
@@ -613,7 +787,7 @@ void UpdateDisplay(bool updateFlag)
     }
     else if (selectedMenuItem == NUMALARMS)
     {
-      sprintf(buf, "%u        ", userParams.numAlarms);
+      sprintf(buf, "%u", userParams.numAlarms);
     }
     else if (selectedMenuItem == ALARM_HOUR)
     {
@@ -632,54 +806,32 @@ void UpdateDisplay(bool updateFlag)
     else if (selectedMenuItem == COLOR)
     {
       if (displayValue)
-      {
-        sprintf(buf, "%-9s\n", colorText[userParams.color]);
-        display.println(buf);
-      }
-      else
-        display.println(F("         "));
+        strcpy(buf, colorText[userParams.color]);
     }
     else if (selectedMenuItem == PATTERN)
     {
       if (displayValue)
-      {
-        sprintf(buf, "%-9s\n", patternText[userParams.pattern]);
-        display.println(buf);
-      }
-      else
-        display.println(F("         "));
+        strcpy(buf, patternText[userParams.pattern]);
     }
     else if (selectedMenuItem == SPEED)
     {
       if (displayValue)
-      {
-        sprintf(buf, "%-9s\n", speedText[userParams.speed]);
-        display.println(buf);
-      }
-      else
-        display.println(F("         "));
+        strcpy(buf, speedText[userParams.speed]);
+    }
+    else if (selectedMenuItem == HISTORY)
+    {
+      sprintf(buf, "Avg: %um", adherenceLog.meanResponseMinutes());
     }
 
-    display.println(buf);
-    display.display();
+    display.printRow(1, buf);
   }
 }
 
 // Debug.
-void printDateTime(const RtcDateTime &dt)
+void LogDateTime(const RtcDateTime &dt)
 {
-  char datestring[20];
-
-  snprintf_P(datestring,
-             countof(datestring),
-             PSTR("%02u/%02u/%04u %02u:%02u:%02u"),
-             dt.Month(),
-             dt.Day(),
-             dt.Year(),
-             dt.Hour(),
-             dt.Minute(),
-             dt.Second());
-  Serial.print(datestring);
+  LOG_DEBUG(LOG_DATE, dt.Year() * 10000L + dt.Month() * 100 + dt.Day());
+  LOG_DEBUG(LOG_TIME, dt.Hour() * 10000L + dt.Minute() * 100 + dt.Second());
 }
 
 void SetupRTC()
@@ -692,8 +844,7 @@ void SetupRTC()
   {
     if (Rtc.LastError() != 0)
     {
-      Serial.print("RTC communications error = ");
-      Serial.println(Rtc.LastError());
+      LOG_ERROR(LOG_RTC_COMMS_ERROR, Rtc.LastError());
       Error();
     }
     else
@@ -701,67 +852,58 @@ void SetupRTC()
       // Common Causes:
       //    1) first time you ran and the device wasn't running yet
       //    2) the battery on the device is low or even missing
-      Serial.println(F("RTC lost confidence in the DateTime!"));
+      rtcSetupFlags |= RTC_LOST_CONFIDENCE;
       Rtc.SetDateTime(compiled);
     }
   }
 
   if (!Rtc.GetIsRunning())
   {
-    Serial.println(F("RTC was not actively running, starting now"));
+    rtcSetupFlags |= RTC_WAS_STOPPED;
     Rtc.SetIsRunning(true);
   }
 
   RtcDateTime now = Rtc.GetDateTime();
   if (now < compiled)
   {
-    Serial.println(F("RTC is older than compile time!  (Updating DateTime)"));
+    rtcSetupFlags |= RTC_OLDER_THAN_COMPILE;
     Rtc.SetDateTime(compiled);
   }
-  else if (now > compiled)
-  {
-    Serial.println(F("RTC is newer than compile time. (this is expected)"));
-  }
-  else if (now == compiled)
-  {
-    Serial.println(F("RTC is the same as compile time! (not expected but all is fine)"));
-  }
 
   Rtc.SetSquareWavePin(DS1307SquareWaveOut_Low);
-
-  Serial.println(F("RTC setup finished."));
 }
 
 void LoadEEPROMData()
 {
   EEPROM.get(0, userParams);
 
-  // Check if EEPROM data has not not been initiated.
-  for (int i = 0; i < maxNumAlarms; i++)
+  // Check if EEPROM data has not not been initiated. Erased EEPROM reads
+  // back as 0xFF bytes, which is -1 for the int fields.
+  for (int i = 0; i < Board::maxNumAlarms; i++)
   {
-    if (userParams.alarms[i].hour == 255)
+    if (userParams.alarms[i].hour > 23)
     {
       userParams.alarms[i].hour = 0;
     }
-    if (userParams.alarms[i].minute == 255)
+    if (userParams.alarms[i].minute > 59)
     {
       userParams.alarms[i].minute = 0;
     }
   }
 
-  if (userParams.color == 255)
+  if (userParams.color < 0 || userParams.color >= numColors)
   {
     userParams.color = 0;
   }
-  if (userParams.pattern == 255)
+  if (userParams.pattern < 0 || userParams.pattern >= MAX_PATTERN)
   {
     userParams.pattern = 0;
   }
-  if (userParams.speed == 255)
+  if (userParams.speed < 0 || userParams.speed >= MAX_SPEED)
   {
     userParams.speed = 0;
   }
-  if (userParams.numAlarms == 255)
+  if (userParams.numAlarms < 1 || userParams.numAlarms > Board::maxNumAlarms)
   {
     userParams.numAlarms = 1;
   }
@@ -774,6 +916,11 @@ void SaveEEPROMData()
 
 void BlinkOnboardLED()
 {
+  if (!Board::hasHeartbeatLed)
+  {
+    return;
+  }
+
   static unsigned long builtinLedMillis;
   static bool toggle;
   unsigned int delay = toggle ? 100 : 900;
@@ -781,51 +928,210 @@ void BlinkOnboardLED()
   {
     builtinLedMillis = millis();
     toggle = !toggle;
-    digitalWrite(PIN_LED_BUILTIN, toggle);
+    digitalWrite(Board::pinLedBuiltin, toggle);
   }
 }
 
-void setup()
+void ProcessTime()
 {
-  Serial.begin(115200);
-  Serial.println(F("ReMEDer starting up..."));
+  if (Rtc.IsDateTimeValid())
+  {
+    RtcDateTime dateTime = Rtc.GetDateTime();
+    timeHour = dateTime.Hour();
+    timeMinute = dateTime.Minute();
+    nowSeconds = dateTime.TotalSeconds();
 
-  strip.begin();
-  strip.show();
+    // Trigger alarm only once upon time clocking into an alarm value.
+    int alarm = CheckAlarms(alarmClock, userParams.alarms, userParams.numAlarms, timeHour, timeMinute);
+    if (alarm >= 0)
+    {
+      indicatorOn = true;
+      activeZones |= 1 << (alarm % numZones);
+      adherenceLog.fired(alarm, nowSeconds);
+#if BOARD_HAS_PIEZO
+      StartPiezo();
+#endif
+    }
+  }
+  else
+  {
+    // RTC error, likely bad battery.
+    Error();
+  }
+}
 
-  pinMode(PIN_LED_BUILTIN, OUTPUT);
-  pinMode(PIN_LED_RESET_BUTTON, OUTPUT);
+#ifdef BENCHMARK
+unsigned long firstAlarmCheckMicros;
 
-  buttonReset.begin();
-  buttonSelect.begin();
-  buttonPrev.begin();
-  buttonNext.begin();
+// Cost of the piezo ISR's sample generator, run on a scratch synth.
+void BenchmarkToneSynth()
+{
+  ToneSynth synth;
+  synth.start(alarmMelody, sizeof(alarmMelody) / sizeof(alarmMelody[0]), toneSquare);
+  volatile uint8_t sample;
+  unsigned long start = micros();
+  for (int i = 0; i < 1024; i++)
+  {
+    sample = synth.nextSample();
+  }
+  (void)sample;
+  LogWrite(LOG_BENCH_TONE_1024_US, micros() - start);
+}
 
-  SetupRTC();
+// Cost of the ambient light filter, run on a scratch filter.
+void BenchmarkAmbientLight()
+{
+  AmbientLight light;
+  unsigned long start = micros();
+  for (int i = 0; i < 1024; i++)
+  {
+    light.addSample(i);
+  }
+  LogWrite(LOG_BENCH_LIGHT_1024_US, micros() - start);
+}
+#endif
 
-  delay(1000);
+// Startup work that is not needed to show an alarm, run from loop() so
+// the indicator and alarm check come up first after a reset.
+// Returns true when the display has just been started.
+bool ProcessDeferredInit()
+{
+  // Startup reports, one per pass so they never pile up in the TX buffer.
+  static byte reportStep;
+  if (reportStep <= 10)
+  {
+    byte step = reportStep++;
+    if (step == 0)
+    {
+      LOG_INFO(LOG_STARTUP);
+    }
+    else if (step == 1 && (rtcSetupFlags & RTC_LOST_CONFIDENCE))
+    {
+      LOG_ERROR(LOG_RTC_LOST_CONFIDENCE);
+    }
+    else if (step == 2 && (rtcSetupFlags & RTC_WAS_STOPPED))
+    {
+      LOG_ERROR(LOG_RTC_WAS_STOPPED);
+    }
+    else if (step == 3 && (rtcSetupFlags & RTC_OLDER_THAN_COMPILE))
+    {
+      LOG_INFO(LOG_RTC_OLDER_THAN_COMPILE);
+    }
+    else if (step == 4)
+    {
+      LOG_INFO(LOG_RTC_SETUP_FINISHED);
+    }
+    else if (step == 5)
+    {
+      LogDateTime(Rtc.GetDateTime());
+    }
+    else if (step == 6)
+    {
+      LOG_INFO(LOG_MISSED_THIS_WEEK, adherenceLog.missedThisWeek(nowSeconds / 86400));
+    }
+    else if (step == 7)
+    {
+      LOG_INFO(LOG_MEAN_RESPONSE, adherenceLog.meanResponseMinutes());
+    }
+#ifdef BENCHMARK
+    else if (step == 8)
+    {
+      LogWrite(LOG_FIRST_ALARM_CHECK_US, firstAlarmCheckMicros);
+    }
+    else if (step == 9)
+    {
+      BenchmarkToneSynth();
+    }
+    else if (step == 10)
+    {
+      BenchmarkAmbientLight();
+    }
+#endif
+  }
 
-  if (!display.begin(SSD1306_SWITCHCAPVCC, 0x3C))
+  // Poll the OLED until it answers instead of waiting a fixed time for it
+  // to power up.
+  static unsigned long lastPollMillis;
+  if (DisplayPresent() && !displayReadyFlag && millis() - lastPollMillis > 50)
   {
-    Serial.println(F("SSD1306 allocation failed."));
-    Error();
+    lastPollMillis = millis();
+    if (display.begin(Board::displayAddress))
+    {
+      displayReadyFlag = true;
+      if (!displayOnFlag)
+      {
+        display.command(SSD1306_DISPLAYOFF);
+      }
+      LOG_INFO(LOG_DISPLAY_STARTED);
+      return true;
+    }
+    if (millis() > displayReadyTimeout)
+    {
+      // Alarms matter more than the menu, carry on without it.
+      LOG_ERROR(LOG_DISPLAY_NOT_RESPONDING);
+      displayFailedFlag = true;
+      displayOnFlag = false;
+    }
   }
-  else
+
+  return false;
+}
+
+void setup()
+{
+  Serial.begin(115200);
+
+  strip.begin();
+  strip.show();
+  for (int i = 0; i < numZones; i++)
+  {
+    ResetZoneState(zoneStates[i]);
+  }
+
+  if (Board::hasHeartbeatLed)
+  {
+    pinMode(Board::pinLedBuiltin, OUTPUT);
+  }
+  pinMode(Board::pinLedResetButton, OUTPUT);
+#if BOARD_HAS_PIEZO
+  SetupPiezo(Board::pinPiezo);
+#endif
+#if BOARD_HAS_LIGHT_SENSOR
+  SetupAmbientLight(Board::lightSensorChannel);
+#endif
+
+  buttonReset.begin();
+  if (Board::hasDisplay)
   {
-    Serial.println(F("SSD1306 allocated."));
+    buttonSelect.begin();
+    buttonPrev.begin();
+    buttonNext.begin();
   }
 
   LoadEEPROMData();
+
+  SetupRTC();
+  nowSeconds = Rtc.GetDateTime().TotalSeconds();
+  adherenceLog.begin(nowSeconds / 86400);
+
+  ProcessTime();
+#ifdef BENCHMARK
+  firstAlarmCheckMicros = micros();
+#endif
+
+  BENCHMARK_LATENCY_SETUP();
 }
 
 void loop()
 {
   static unsigned long displayTimeoutMillis;
 
+  BENCHMARK_BEGIN(loopProbe);
+
   BlinkOnboardLED();
 
-  bool updateFlag = false;
-  if (ProcessControlButtons())
+  bool updateFlag = ProcessDeferredInit();
+  if (DisplayPresent() && ProcessControlButtons())
   {
     updateFlag = true;
     displayOnFlag = true;
@@ -837,8 +1143,10 @@ void loop()
     {
       oldTimeHour = timeHour;
       oldTimeMinute = timeMinute;
-      Rtc.SetDateTime(RtcDateTime(2020, 1, 1, timeHour, timeMinute, 0));
-      Serial.println(F("Saving time data to RTC."));
+      // Keep the date, the adherence log counts days.
+      RtcDateTime now = Rtc.GetDateTime();
+      Rtc.SetDateTime(RtcDateTime(now.Year(), now.Month(), now.Day(), timeHour, timeMinute, 0));
+      LOG_INFO(LOG_TIME_SAVED);
     }
   }
 
@@ -847,68 +1155,58 @@ void loop()
   {
     displayTimeoutMillis = millis();
     displayOnFlag = false;
-    display.ssd1306_command(SSD1306_DISPLAYOFF);
+    if (displayReadyFlag)
+    {
+      display.command(SSD1306_DISPLAYOFF);
+    }
   }
 
-  if (displayOnFlag)
+  if (DisplayPresent() && displayOnFlag && displayReadyFlag)
   {
-    display.ssd1306_command(SSD1306_DISPLAYON);
+    display.command(SSD1306_DISPLAYON);
     UpdateDisplay(updateFlag);
   }
 
-  // Check if time has updated.
-  if (Rtc.IsDateTimeValid())
-  {
-    RtcDateTime dateTime = Rtc.GetDateTime();
-    timeHour = dateTime.Hour();
-    timeMinute = dateTime.Minute();
-
-    // Trigger alarm only once upon time clocking into an alarm value.
-    static int oldTimeHour, oldTimeMinute;
-    if (oldTimeHour != timeHour || oldTimeMinute != timeMinute)
-    {
-      oldTimeHour = timeHour;
-      oldTimeMinute = timeMinute;
-
-      // Check for alarm trigger.
-      for (int i = 0; i < userParams.numAlarms; i++)
-      {
-        if (timeHour == userParams.alarms[i].hour && timeMinute == userParams.alarms[i].minute)
-        {
-          indicatorOn = true;
-        }
-      }
-    }
-  }
-  else
-  {
-    // RTC error, likely bad battery.
-    Error();
-  }
+  ProcessTime();
 
   if (ProcessResetButton())
   {
     indicatorOn = false;
+    activeZones = 0;
+    adherenceLog.acknowledged(nowSeconds);
+#if BOARD_HAS_PIEZO
+    StopPiezo();
+#endif
   }
 
   // Show alarm indicator when activated by the alarm or
   // when the user is interacting with certain menu items.
-  if (displayOnFlag)
+  if (DisplayPresent() && displayOnFlag)
   {
     if (selectedMenuItem == COLOR || selectedMenuItem == PATTERN || selectedMenuItem == SPEED)
     {
-      ProcessIndicator(true);
+      ProcessIndicator(true, allZones);
     }
     else
     {
-      ProcessIndicator(false);
+      ProcessIndicator(false, 0);
     }
   }
   else
   {
-    ProcessIndicator(indicatorOn);
-    analogWrite(PIN_LED_RESET_BUTTON, indicatorOn ? 127 : 0);
+    ProcessIndicator(indicatorOn, activeZones);
+    analogWrite(Board::pinLedResetButton, indicatorOn ? 127 : 0);
+  }
+
+  static unsigned long currentLogMillis;
+  if (millis() - currentLogMillis > 1000)
+  {
+    currentLogMillis = millis();
+    LOG_INFO(LOG_STRIP_MILLIAMPS, stripMilliamps);
   }
 
   SaveEEPROMData();
+
+  BENCHMARK_END(loopProbe);
+  BENCHMARK_LATENCY_REPORT();
 }
\ No newline at end of file
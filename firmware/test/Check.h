@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Stops the test at the first failed check.
+#define CHECK(condition)                                                   \
+  do                                                                       \
+  {                                                                        \
+    if (!(condition))                                                      \
+    {                                                                      \
+      fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #condition); \
+      exit(1);                                                             \
+    }                                                                      \
+  } while (0)
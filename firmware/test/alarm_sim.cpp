@@ -0,0 +1,549 @@
+// Alarm simulator: runs the real setup() and loop() on the host with a
+// fake RTC that jumps ahead on every loop pass, replays button scripts and
+// checks the alarm invariants over a simulated year:
+//   - an alarm due at power up lights the indicator on the first pass
+//   - each alarm fires exactly once per day, at its minute
+//   - the reset button clears the indicator
+//   - no frame is shown over the current budget
+//   - on SPI strips, the bytes on the wire decode back to the frame
+//   - with several zones, an alarm lights its own zone and no other
+//   - the adherence log's missed count and mean response time match the
+//     script, which leaves some doses unreset and power cycles mid-year
+// Profiles without the menu get their alarms from EEPROM instead.
+// With SIM_NO_DISPLAY the OLED never answers and the unit has to carry on
+// as if it were headless.
+
+#include "../src/main.cpp"
+#include "Check.h"
+
+// RTC seconds per loop pass, small enough to see every minute.
+const uint32_t rtcStepSeconds = 20;
+const unsigned long loopMicros = 20000;
+
+// Alarm times, a few minutes apart so each can be reset before the next fires.
+// The simulation powers up at the first one.
+const Alarm simAlarms[] = {{0, 1}, {6, 30}, {12, 0}, {17, 45}, {23, 55}, {23, 59}, {3, 3}};
+static_assert(Board::maxNumAlarms <= countof(simAlarms), "Add alarm times for this profile");
+
+#ifdef SIM_NO_DISPLAY
+const bool simDisplay = false;
+#else
+const bool simDisplay = Board::hasDisplay;
+#endif
+
+void Step(uint32_t rtcSeconds)
+{
+  hostRtcSeconds += rtcSeconds;
+  HostAdvanceMicros(loopMicros);
+  loop();
+}
+
+void Press(uint8_t pin)
+{
+  hostPinLevel[pin] = LOW;
+  Step(0);
+  hostPinLevel[pin] = HIGH;
+  Step(0);
+}
+
+// Button script: N next, P prev, S select, R reset, a number repeats the
+// key after it, e.g. "S23NS".
+void RunScript(const char *script)
+{
+  while (*script)
+  {
+    int count = 1;
+    if (*script >= '0' && *script <= '9')
+    {
+      count = strtol(script, (char **)&script, 10);
+    }
+
+    uint8_t pin = *script == 'N'   ? Board::pinButtonNext
+                  : *script == 'P' ? Board::pinButtonPrev
+                  : *script == 'S' ? Board::pinButtonSelect
+                                   : Board::pinButtonReset;
+    for (int i = 0; i < count; i++)
+    {
+      Press(pin);
+    }
+    script++;
+  }
+}
+
+void RunScriptf(const char *format, int value)
+{
+  char script[16];
+  snprintf(script, sizeof(script), format, value);
+  RunScript(script);
+}
+
+// Let the display time out, the next key press only wakes it.
+void WaitForDisplayOff()
+{
+  for (int i = 0; i < 11000 / (loopMicros / 1000); i++)
+  {
+    Step(0);
+  }
+  CHECK(!displayOnFlag);
+}
+
+// Set the alarms through the menu, checking the wrap of each value.
+void SetAlarmsFromMenu()
+{
+  WaitForDisplayOff();
+  RunScript("N");
+  CHECK(selectedMenuItem == TIME_HOUR);
+
+  RunScript("SS");
+  CHECK(selectedMenuItem == NUMALARMS);
+  CHECK(userParams.numAlarms == 1);
+  RunScriptf("%dN", Board::maxNumAlarms - 1);
+  CHECK(userParams.numAlarms == Board::maxNumAlarms);
+  RunScript("N");
+  CHECK(userParams.numAlarms == 1);
+  RunScript("P");
+  CHECK(userParams.numAlarms == Board::maxNumAlarms);
+
+  RunScript("S");
+  CHECK(selectedMenuItem == ALARM_HOUR && selectedAlarm == 1);
+  RunScript("23N");
+  CHECK(userParams.alarms[0].hour == 23);
+  RunScript("N");
+  CHECK(userParams.alarms[0].hour == 0);
+  RunScript("P");
+  CHECK(userParams.alarms[0].hour == 23);
+  RunScript("N");
+
+  for (int i = 0; i < Board::maxNumAlarms; i++)
+  {
+    CHECK(selectedMenuItem == ALARM_HOUR && selectedAlarm == i + 1);
+    int hours = (simAlarms[i].hour - userParams.alarms[i].hour + 24) % 24;
+    if (hours)
+    {
+      RunScriptf("%dN", hours);
+    }
+    RunScript("S");
+    CHECK(selectedMenuItem == ALARM_MIN);
+    int minutes = (simAlarms[i].minute - userParams.alarms[i].minute + 60) % 60;
+    if (minutes)
+    {
+      RunScriptf("%dN", minutes);
+    }
+    RunScript("S");
+    CHECK(userParams.alarms[i].hour == simAlarms[i].hour);
+    CHECK(userParams.alarms[i].minute == simAlarms[i].minute);
+  }
+  CHECK(selectedMenuItem == COLOR);
+
+  WaitForDisplayOff();
+}
+
+// Units without a working display are provisioned with all alarms in
+// EEPROM, the others only with the first one and set the rest through the
+// menu.
+void SetAlarmsInEEPROM()
+{
+  UserParams params = {};
+  params.numAlarms = simDisplay ? 1 : Board::maxNumAlarms;
+  memcpy(params.alarms, simAlarms, sizeof(params.alarms[0]) * params.numAlarms);
+  EEPROM.put(0, params);
+}
+
+uint32_t StripChannelSum()
+{
+  uint32_t sum = 0;
+  for (int i = 0; i < Board::numPixels; i++)
+  {
+    uint32_t c = strip.getPixelColor(i);
+    sum += (uint8_t)(c >> 16) + (uint8_t)(c >> 8) + (uint8_t)c;
+  }
+  return sum;
+}
+
+// Decodes the last frame sent over SPI, 4 symbols per color byte in green,
+// red, blue order, and compares it with the pixels. See SpiNeoPixel.h.
+void CheckSpiFrame()
+{
+  if (!Board::ledStripOnSpi)
+  {
+    return;
+  }
+
+  const uint8_t symbols[4] = {0x88, 0x8E, 0xE8, 0xEE};
+  CHECK(hostSpiLength == Board::numPixels * 3 * 4);
+  for (int i = 0; i < Board::numPixels; i++)
+  {
+    uint8_t grb[3] = {};
+    for (int j = 0; j < 3 * 4; j++)
+    {
+      uint8_t symbol = hostSpiBytes[i * 3 * 4 + j];
+      int pair = 0;
+      while (pair < 4 && symbols[pair] != symbol)
+      {
+        pair++;
+      }
+      CHECK(pair < 4);
+      grb[j / 4] = (grb[j / 4] << 2) | pair;
+    }
+    uint32_t c = strip.getPixelColor(i);
+    CHECK(grb[0] == (uint8_t)(c >> 8));
+    CHECK(grb[1] == (uint8_t)(c >> 16));
+    CHECK(grb[2] == (uint8_t)c);
+  }
+}
+
+bool ZoneDark(int zoneIndex)
+{
+  const Zone &zone = Board::zones[zoneIndex];
+  for (int i = zone.firstPixel; i < zone.firstPixel + zone.numPixels; i++)
+  {
+    if (strip.getPixelColor(i) != 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Alarm n lights zone (n % numZones) once its pattern comes round, within
+// two slow flashes, and the other zones are dark once the fade from the
+// previous frame is done. Alarms are only minutes apart in RTC time here,
+// so the last one may still be fading out.
+void CheckAlarmZone(int alarm)
+{
+  const int litZone = alarm % numZones;
+  CHECK(activeZones == 1 << litZone);
+  const unsigned long maxSteps = 2000UL * Board::FlashDelay(SLOW) / loopMicros;
+  unsigned long steps = 0;
+  while (fadeActiveFlag && steps++ < maxSteps)
+  {
+    Step(0);
+  }
+  CHECK(!fadeActiveFlag);
+
+  steps = 0;
+  while (true)
+  {
+    for (int i = 0; i < numZones; i++)
+    {
+      CHECK(i == litZone || ZoneDark(i));
+    }
+    if (!ZoneDark(litZone) || steps++ >= maxSteps)
+    {
+      break;
+    }
+    Step(0);
+  }
+  CHECK(!ZoneDark(litZone));
+}
+
+// A full white frame is over budget on its first pass, steady or fading in.
+void CheckCurrentLimit()
+{
+  const uint32_t white = Color(255, 255, 255);
+  const uint32_t budgetChannelSum = (uint32_t)channelBudgetMilliamps * 255 / Board::milliampsPerChannel;
+  CHECK(Board::numPixels * 765UL > budgetChannelSum);
+
+#if BOARD_HAS_LIGHT_SENSOR
+  // Daylight, so the brightness ceiling stays out of the way.
+  ADC = 1023;
+  for (int i = 0; i < AmbientLight::decimation; i++)
+  {
+    ADC_vect();
+  }
+  CHECK(ambientLight.level() == 255);
+
+  // A frame under the budget is shown as drawn.
+  const uint32_t dim = Color(10, 20, 30);
+  strip.fill(0, 0, Board::numPixels);
+  strip.setPixelColor(0, dim);
+  frameChannelSum = 60;
+  fadeActiveFlag = false;
+  ProcessOutput();
+  CHECK(strip.getPixelColor(0) == dim);
+#endif
+
+  strip.fill(white, 0, Board::numPixels);
+  frameChannelSum = Board::numPixels * 765UL;
+  fadeActiveFlag = false;
+  ProcessOutput();
+  CHECK(StripChannelSum() <= budgetChannelSum);
+  CHECK(StripChannelSum() >= budgetChannelSum * 9 / 10);
+  CHECK(stripMilliamps <= Board::currentBudgetMilliamps);
+
+  memset(fadeFromFrame, 255, sizeof(fadeFromFrame));
+  fadeFromSum = sizeof(fadeFromFrame) * 255UL;
+  strip.fill(white, 0, Board::numPixels);
+  fadeStartMillis = millis() - fadeMillis / 2;
+  fadeActiveFlag = true;
+  ProcessOutput();
+  CHECK(StripChannelSum() <= budgetChannelSum);
+  CHECK(stripMilliamps <= Board::currentBudgetMilliamps);
+}
+
+// Shadow of the adherence log: the doses in the order the script fired
+// them, with the minutes to their reset, to check the firmware's
+// aggregates against. See AdherenceLog.h.
+const int simLogRecords = 128; // As passed to adherenceLog in main.cpp.
+struct SimDose
+{
+  uint16_t day;
+  uint8_t minutes;
+};
+SimDose simDoses[simLogRecords];
+int simNumDoses; // Fired so far, only the last simLogRecords are kept.
+bool simPendingFlag;
+uint32_t simPendingSeconds;
+int simMissed;
+
+void SimFired(uint32_t seconds)
+{
+  simDoses[simNumDoses % simLogRecords] = {(uint16_t)(seconds / 86400), ADHERENCE_MISSED};
+  simNumDoses++;
+  simPendingFlag = true;
+  simPendingSeconds = seconds;
+}
+
+void SimReset(uint32_t seconds)
+{
+  if (simPendingFlag)
+  {
+    uint32_t minutes = (seconds - simPendingSeconds) / 60;
+    simDoses[(simNumDoses - 1) % simLogRecords].minutes = minutes < ADHERENCE_MISSED ? minutes : ADHERENCE_MISSED - 1;
+    simPendingFlag = false;
+  }
+}
+
+// Open doses count as missed once the next one fires or on power up.
+void CheckAdherence()
+{
+  uint16_t today = hostRtcSeconds / 86400;
+  int missed = 0;
+  uint32_t responseTotal = 0;
+  int responseCount = 0;
+  for (int age = 0; age < simNumDoses && age < simLogRecords; age++)
+  {
+    const SimDose &dose = simDoses[(simNumDoses - 1 - age) % simLogRecords];
+    if (dose.minutes != ADHERENCE_MISSED)
+    {
+      responseTotal += dose.minutes;
+      responseCount++;
+    }
+    else if (!(age == 0 && simPendingFlag) && today - dose.day < 7)
+    {
+      missed++;
+    }
+  }
+  CHECK(adherenceLog.missedThisWeek(today) == missed);
+  CHECK(adherenceLog.meanResponseMinutes() == (responseCount ? responseTotal / responseCount : 0));
+}
+
+// Power cycle: the RTC and EEPROM keep going, the RAM and registers the
+// firmware expects cleared at power up are cleared before setup() runs.
+void Reboot()
+{
+  indicatorOn = false;
+  activeZones = 0;
+  alarmClock = AlarmClock();
+#if BOARD_HAS_PIEZO
+  StopPiezo();
+#endif
+  setup();
+  simPendingFlag = false;
+}
+
+// Number of log frames sent with the message, see Log.h.
+int LogCount(uint8_t id)
+{
+  int count = 0;
+  for (size_t i = 0; i + LOG_FRAME_SIZE <= Serial.length; i++)
+  {
+    if (Serial.buffer[i] == LOG_FRAME_SYNC && Serial.buffer[i + 1] == id)
+    {
+      count++;
+    }
+  }
+  return count;
+}
+
+bool LogSent(uint8_t id)
+{
+  return LogCount(id) != 0;
+}
+
+int FindAlarm(int hour, int minute)
+{
+  for (int i = 0; i < userParams.numAlarms; i++)
+  {
+    if (userParams.alarms[i].hour == hour && userParams.alarms[i].minute == minute)
+    {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int main()
+{
+  const uint32_t start = RtcDateTime(2030, 1, 1, simAlarms[0].hour, simAlarms[0].minute, 0).TotalSeconds();
+  const int numDays = 365;
+
+  hostRtcSeconds = start;
+#ifdef SIM_NO_DISPLAY
+  hostI2cNack = true;
+#endif
+  SetAlarmsInEEPROM();
+  setup();
+
+  // The alarm due at power up shows without waiting for the display.
+  CHECK(indicatorOn);
+  Step(0);
+  CHECK(hostPinAnalog[Board::pinLedResetButton] != 0);
+  for (unsigned long i = 0; i < (fadeMillis + 100) * 1000 / loopMicros; i++)
+  {
+    Step(0);
+  }
+  CHECK(strip.getPixelColor(0) != 0);
+  CheckSpiFrame();
+  SimFired(start);
+  RunScript("R");
+  SimReset(hostRtcSeconds);
+  CHECK(!indicatorOn);
+
+  CheckCurrentLimit();
+
+  if (simDisplay)
+  {
+    SetAlarmsFromMenu();
+  }
+  CHECK(hostRtcSeconds == start);
+  CHECK(!indicatorOn);
+
+  // Every seventh dose is left unreset until the next alarm, the rest are
+  // reset one to three minutes after firing. The unit is power cycled
+  // twice with a dose open: mid-day before the log ring first wraps, and
+  // at midnight after it has wrapped, coming back on after more than a
+  // week unplugged.
+  const int rebootDay = 10;
+  const int powerOffDay = numDays / 2;
+  const int powerOffDays = 9;
+  int reboots = 0;
+  int fires = 1;
+  for (int day = 0; day < numDays; day++)
+  {
+    int firesToday[Board::maxNumAlarms] = {};
+    int resetCountdown = 0;
+    int rebootCountdown = 0;
+    if (day == 0)
+    {
+      firesToday[0] = 1;
+    }
+
+    while (hostRtcSeconds + rtcStepSeconds < start + (day + 1) * 86400UL)
+    {
+      bool wasOn = indicatorOn;
+      int lastMinute = timeHour * 60 + timeMinute;
+      Step(rtcStepSeconds);
+      CHECK(stripMilliamps <= Board::currentBudgetMilliamps);
+      CheckSpiFrame();
+
+      // The indicator only comes on at an alarm minute, and every alarm
+      // minute fires, whether or not the last dose was reset.
+      int alarm = timeHour * 60 + timeMinute != lastMinute ? FindAlarm(timeHour, timeMinute) : -1;
+      CHECK(alarm >= 0 || !indicatorOn || wasOn);
+      if (alarm >= 0)
+      {
+        CHECK(indicatorOn);
+        CHECK(activeZones & (1 << (alarm % numZones)));
+        if (numZones > 1 && !wasOn)
+        {
+          CheckAlarmZone(alarm);
+        }
+        CHECK(hostPinAnalog[Board::pinLedResetButton] != 0);
+#if BOARD_HAS_PIEZO
+        CHECK(TIMSK2 & _BV(OCIE2A));
+#endif
+        SimFired(hostRtcSeconds);
+        firesToday[alarm]++;
+        fires++;
+        resetCountdown = fires % 7 == 3 ? 0 : 4 + 3 * (fires % 3);
+        if (day == rebootDay && !reboots)
+        {
+          resetCountdown = 0;
+          rebootCountdown = 7;
+        }
+        if (day == powerOffDay && timeHour == 23)
+        {
+          resetCountdown = 0;
+        }
+      }
+
+      if (resetCountdown && --resetCountdown == 0)
+      {
+        RunScript("R");
+        SimReset(hostRtcSeconds);
+        CHECK(!indicatorOn);
+        CHECK(activeZones == 0);
+        CHECK(hostPinAnalog[Board::pinLedResetButton] == 0);
+#if BOARD_HAS_PIEZO
+        CHECK(!(TIMSK2 & _BV(OCIE2A)));
+#endif
+      }
+
+      if (rebootCountdown && --rebootCountdown == 0)
+      {
+        CheckAdherence();
+        Reboot();
+        reboots++;
+        CHECK(!indicatorOn);
+        CHECK(userParams.numAlarms == Board::maxNumAlarms);
+        CheckAdherence();
+      }
+    }
+
+    for (int i = 0; i < Board::maxNumAlarms; i++)
+    {
+      if (firesToday[i] != 1)
+      {
+        fprintf(stderr, "FAIL: day %d alarm %d fired %d times\n", day, i, firesToday[i]);
+        return 1;
+      }
+    }
+    CheckAdherence();
+
+    if (day == powerOffDay)
+    {
+      CHECK(indicatorOn);
+      hostRtcSeconds += powerOffDays * 86400UL;
+      day += powerOffDays;
+      Reboot();
+      reboots++;
+      CHECK(!indicatorOn);
+      CheckAdherence();
+    }
+  }
+  CHECK(reboots == 2);
+  CHECK(simNumDoses > simLogRecords);
+  CHECK(adherenceLog.missedThisWeek(hostRtcSeconds / 86400) > 0);
+  CHECK(adherenceLog.meanResponseMinutes() > 1);
+
+  CHECK(LogSent(LOG_STARTUP));
+  CHECK(LogSent(LOG_STRIP_MILLIAMPS));
+
+#ifdef SIM_NO_DISPLAY
+  // Given up on once, and the keys no longer open the menu.
+  CHECK(LogCount(LOG_DISPLAY_NOT_RESPONDING) == 1);
+  CHECK(!displayReadyFlag);
+  RunScript("N");
+  CHECK(!displayOnFlag);
+#endif
+
+  // The heartbeat stays off the pin when it is shared, e.g. with SCK.
+  if (!Board::hasHeartbeatLed)
+  {
+    CHECK(hostPinLevel[Board::pinLedBuiltin] == LOW);
+  }
+
+  printf("%d days, %d alarms fired, %d reboots\n", numDays, fires, reboots);
+  return 0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define NEO_GRB 0x52
+#define NEO_KHZ800 0x0000
+
+// Keeps the frame, show() only counts.
+class Adafruit_NeoPixel
+{
+public:
+  Adafruit_NeoPixel(uint16_t n, int16_t pin, uint16_t type) : count(n) {}
+
+  void begin() {}
+  void show() { shows++; }
+  uint16_t numPixels() const { return count; }
+
+  void setPixelColor(uint16_t n, uint32_t c)
+  {
+    if (n < count)
+    {
+      pixels[n] = c;
+    }
+  }
+
+  uint32_t getPixelColor(uint16_t n) const
+  {
+    return n < count ? pixels[n] : 0;
+  }
+
+  void fill(uint32_t c, uint16_t first, uint16_t n)
+  {
+    for (uint16_t i = first; i < first + n; i++)
+    {
+      setPixelColor(i, c);
+    }
+  }
+
+  unsigned long shows;
+
+private:
+  uint16_t count;
+  uint32_t pixels[256];
+};
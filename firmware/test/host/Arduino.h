@@ -0,0 +1,132 @@
+#pragma once
+
+// Host stand-in for the Arduino core, enough to build main.cpp with g++.
+// Time moves when the simulator calls HostAdvanceMicros() and a little with
+// each micros() call. Pins and registers are plain variables the simulator
+// can read and set.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F_CPU 8000000UL
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000L)
+
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LOW 0
+#define HIGH 1
+#define A0 14
+
+#define radians(deg) ((deg) * M_PI / 180.0)
+
+inline unsigned long hostMicros;
+inline uint8_t hostPinLevel[32];
+inline int hostPinAnalog[32];
+inline unsigned long hostDelayCalls;
+
+inline void HostAdvanceMicros(unsigned long us)
+{
+  hostMicros += us;
+}
+
+// Each call moves the clock a little, as running code would, so busy waits
+// on micros() end.
+inline unsigned long micros()
+{
+  return hostMicros += 4;
+}
+
+inline unsigned long millis()
+{
+  return hostMicros / 1000;
+}
+
+// Only Error() delays, it never returns on the device.
+inline void delay(unsigned long ms)
+{
+  HostAdvanceMicros(ms * 1000);
+  if (++hostDelayCalls > 100)
+  {
+    fprintf(stderr, "FAIL: firmware stuck in Error()\n");
+    exit(1);
+  }
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (mode == INPUT_PULLUP)
+  {
+    hostPinLevel[pin] = HIGH;
+  }
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value)
+{
+  hostPinLevel[pin] = value;
+}
+
+inline int digitalRead(uint8_t pin)
+{
+  return hostPinLevel[pin];
+}
+
+inline void analogWrite(uint8_t pin, int value)
+{
+  hostPinAnalog[pin] = value;
+}
+
+inline long random(long low, long high)
+{
+  return low + rand() % (high - low);
+}
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+// Serial output is kept so the simulator can inspect the log frames.
+class HardwareSerial
+{
+public:
+  void begin(unsigned long) {}
+  int availableForWrite() { return 63; }
+  size_t write(uint8_t c)
+  {
+    if (length < sizeof(buffer))
+    {
+      buffer[length++] = c;
+    }
+    return 1;
+  }
+  size_t write(const uint8_t *data, size_t n)
+  {
+    for (size_t i = 0; i < n; i++)
+    {
+      write(data[i]);
+    }
+    return n;
+  }
+  size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  size_t print(const __FlashStringHelper *s) { return print((const char *)s); }
+  size_t print(char c) { return write(c); }
+  size_t print(long value)
+  {
+    char text[12];
+    snprintf(text, sizeof(text), "%ld", value);
+    return print(text);
+  }
+
+  uint8_t buffer[4096];
+  size_t length;
+};
+
+inline HardwareSerial Serial;
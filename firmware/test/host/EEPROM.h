@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+
+// 1 KB of EEPROM, erased to 0xFF.
+struct EEPROMClass
+{
+  EEPROMClass() { memset(data, 0xFF, sizeof(data)); }
+
+  uint8_t read(int address) { return data[address]; }
+  void write(int address, uint8_t value) { data[address] = value; }
+  void update(int address, uint8_t value) { data[address] = value; }
+  uint16_t length() { return sizeof(data); }
+
+  template <typename T>
+  T &get(int address, T &t)
+  {
+    memcpy(&t, &data[address], sizeof(T));
+    return t;
+  }
+
+  template <typename T>
+  const T &put(int address, const T &t)
+  {
+    memcpy(&data[address], &t, sizeof(T));
+    return t;
+  }
+
+  uint8_t data[1024];
+};
+
+inline EEPROMClass EEPROM;
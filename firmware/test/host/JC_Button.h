@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Reads the pin level each read(), no debouncing. Buttons pull to ground.
+class Button
+{
+public:
+  Button(uint8_t pin, uint32_t dbTime = 25, uint8_t puEnable = true, uint8_t invert = true) : pin(pin) {}
+
+  void begin()
+  {
+    pinMode(pin, INPUT_PULLUP);
+  }
+
+  bool read()
+  {
+    lastState = state;
+    state = digitalRead(pin) == LOW;
+    return state;
+  }
+
+  bool wasPressed()
+  {
+    return state && !lastState;
+  }
+
+private:
+  uint8_t pin;
+  bool state;
+  bool lastState;
+};
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Seconds since 2000-01-01, as in the Makuna RTC library.
+class RtcDateTime
+{
+public:
+  RtcDateTime(uint32_t seconds = 0) : seconds(seconds) {}
+
+  RtcDateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute, uint8_t second)
+  {
+    uint32_t days = day - 1;
+    for (uint16_t y = 2000; y < year; y++)
+    {
+      days += IsLeapYear(y) ? 366 : 365;
+    }
+    for (uint8_t m = 1; m < month; m++)
+    {
+      days += DaysInMonth(year, m);
+    }
+    seconds = ((days * 24 + hour) * 60 + minute) * 60 + second;
+  }
+
+  // __DATE__ and __TIME__, "Oct 18 2026" and "09:46:12".
+  RtcDateTime(const char *date, const char *time)
+  {
+    static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+    char name[4] = {date[0], date[1], date[2], 0};
+    uint8_t month = (strstr(months, name) - months) / 3 + 1;
+    *this = RtcDateTime(atoi(date + 7), month, atoi(date + 4), atoi(time), atoi(time + 3), atoi(time + 6));
+  }
+
+  uint16_t Year() const { return Civil().year; }
+  uint8_t Month() const { return Civil().month; }
+  uint8_t Day() const { return Civil().day; }
+  uint8_t Hour() const { return seconds / 3600 % 24; }
+  uint8_t Minute() const { return seconds / 60 % 60; }
+  uint8_t Second() const { return seconds % 60; }
+  uint32_t TotalSeconds() const { return seconds; }
+
+  bool operator<(const RtcDateTime &other) const { return seconds < other.seconds; }
+
+private:
+  struct CivilDate
+  {
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+  };
+
+  static bool IsLeapYear(uint16_t year)
+  {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+  }
+
+  static uint8_t DaysInMonth(uint16_t year, uint8_t month)
+  {
+    static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return month == 2 && IsLeapYear(year) ? 29 : days[month - 1];
+  }
+
+  CivilDate Civil() const
+  {
+    CivilDate date = {2000, 1, 1};
+    uint32_t days = seconds / 86400;
+    while (days >= (IsLeapYear(date.year) ? 366u : 365u))
+    {
+      days -= IsLeapYear(date.year) ? 366 : 365;
+      date.year++;
+    }
+    while (days >= DaysInMonth(date.year, date.month))
+    {
+      days -= DaysInMonth(date.year, date.month);
+      date.month++;
+    }
+    date.day += days;
+    return date;
+  }
+
+  uint32_t seconds;
+};
+
+enum DS1307SquareWaveOut
+{
+  DS1307SquareWaveOut_Low
+};
+
+// Always valid and running. The time is hostRtcSeconds, which only the
+// simulator and SetDateTime() move.
+inline uint32_t hostRtcSeconds;
+
+template <class T>
+class RtcDS1307
+{
+public:
+  RtcDS1307(T &wire) {}
+
+  void Begin() {}
+  bool IsDateTimeValid() { return true; }
+  uint8_t LastError() { return 0; }
+  bool GetIsRunning() { return true; }
+  void SetIsRunning(bool) {}
+  void SetSquareWavePin(DS1307SquareWaveOut) {}
+
+  void SetDateTime(const RtcDateTime &dt) { hostRtcSeconds = dt.TotalSeconds(); }
+  RtcDateTime GetDateTime() { return RtcDateTime(hostRtcSeconds); }
+};
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+struct SPISettings
+{
+  SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+// Bytes sent in the last transaction, for the tests to decode.
+inline uint8_t hostSpiBytes[1024];
+inline size_t hostSpiLength;
+
+class SPIClass
+{
+public:
+  void begin() {}
+  void beginTransaction(SPISettings) { hostSpiLength = 0; }
+  void endTransaction() {}
+  uint8_t transfer(uint8_t data)
+  {
+    if (hostSpiLength < sizeof(hostSpiBytes))
+    {
+      hostSpiBytes[hostSpiLength++] = data;
+    }
+    return 0;
+  }
+};
+
+inline SPIClass SPI;
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Every I2C device answers unless the test sets hostI2cNack.
+inline bool hostI2cNack = false;
+
+class TwoWire
+{
+public:
+  void begin() {}
+  void beginTransmission(uint8_t) {}
+  uint8_t endTransmission() { return hostI2cNack ? 2 : 0; }
+  size_t write(uint8_t) { return 1; }
+};
+
+inline TwoWire Wire;
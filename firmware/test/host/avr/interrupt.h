@@ -0,0 +1,7 @@
+#pragma once
+
+// ISRs become plain functions the simulator can call.
+#define ISR(vector) void vector()
+
+inline void sei() {}
+inline void cli() {}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <stdint.h>
+
+// The registers main.cpp touches, as plain variables.
+
+#define _BV(bit) (1 << (bit))
+
+inline volatile uint8_t SREG;
+inline volatile uint8_t ADMUX, ADCSRA, ADCSRB, DIDR0;
+inline volatile uint16_t ADC;
+inline volatile uint8_t TCCR1A, TCCR1B, TIMSK1;
+inline volatile uint16_t OCR1A, OCR1B, TCNT1;
+inline volatile uint8_t TCCR2A, TCCR2B, TIMSK2, OCR2A, TCNT2;
+
+#define REFS0 6
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+
+#define WGM10 0
+#define WGM12 3
+#define COM1B1 5
+#define CS10 0
+
+#define WGM21 1
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define OCIE2A 1
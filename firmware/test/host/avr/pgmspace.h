@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string.h>
+
+// Flash and RAM share one address space on the host.
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_ptr(p) (*(const void *const *)(p))
+#define strlen_P strlen
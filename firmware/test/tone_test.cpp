@@ -0,0 +1,114 @@
+// Captures the alarm melody from ToneSynth, built without the Arduino core,
+// and checks the sample stream:
+//   - rests are silence (128) once the release of the beep before has run
+//   - beeps take at least 2 ms to rise from silence, so they do not click,
+//     reach full volume and keep sounding until their release
+//   - beeps have the melody's pitch and the stream repeats with the melody
+// Pass a file name to also write the samples as raw unsigned 8 bit PCM,
+// e.g. aplay -r 8000 -f U8 tone.raw
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../src/ToneSynth.h"
+#include "Check.h"
+
+const int numNotes = sizeof(alarmMelody) / sizeof(alarmMelody[0]);
+
+// Envelope rise per sample for a 2 ms attack at 8 kHz.
+const int maxAttackStep = 256 / 16;
+
+int Amplitude(uint8_t sample)
+{
+  return abs(sample - 128);
+}
+
+int main(int argc, char **argv)
+{
+  int period = 0;
+  int beepsPerPeriod = 0;
+  for (int i = 0; i < numNotes; i++)
+  {
+    period += alarmMelody[i].samples;
+    beepsPerPeriod += alarmMelody[i].phaseStep != 0;
+  }
+
+  const int numSamples = 3 * period;
+  uint8_t *samples = (uint8_t *)malloc(numSamples);
+
+  ToneSynth synth;
+  synth.start(alarmMelody, numNotes, toneSquare);
+  CHECK(synth.playing());
+  for (int i = 0; i < numSamples; i++)
+  {
+    samples[i] = synth.nextSample();
+  }
+
+  if (argc > 1)
+  {
+    FILE *file = fopen(argv[1], "wb");
+    CHECK(file);
+    fwrite(samples, 1, numSamples, file);
+    fclose(file);
+  }
+
+  int start = 0;
+  int beeps = 0;
+  for (int n = 0; n < 2 * numNotes; n++)
+  {
+    const ToneNote &note = alarmMelody[n % numNotes];
+    const uint8_t *s = &samples[start];
+
+    if (note.phaseStep == 0)
+    {
+      for (int i = 0; i < note.samples; i++)
+      {
+        CHECK(s[i] == 128);
+      }
+    }
+    else
+    {
+      beeps++;
+      int loudest = 0;
+      int cycles = 0;
+      for (int i = 0; i < note.samples; i++)
+      {
+        int envelope = (i + 1) * maxAttackStep;
+        CHECK(Amplitude(s[i]) <= (127 * (envelope < 255 ? envelope : 255) >> 8) + 1);
+        if (i < note.samples - ToneSynth::releaseSamples && Amplitude(s[i]) > loudest)
+        {
+          loudest = Amplitude(s[i]);
+        }
+        if (i > 0 && s[i - 1] < 128 && s[i] >= 128)
+        {
+          cycles++;
+        }
+      }
+      CHECK(loudest >= 120);
+
+      // Still at full volume just before the release starts.
+      int tail = 0;
+      for (int i = note.samples - 2 * ToneSynth::releaseSamples; i < note.samples - ToneSynth::releaseSamples; i++)
+      {
+        tail = Amplitude(s[i]) > tail ? Amplitude(s[i]) : tail;
+      }
+      CHECK(tail >= 120);
+
+      int expectedCycles = (long)note.phaseStep * note.samples / 65536;
+      CHECK(abs(cycles - expectedCycles) <= 1);
+    }
+    start += note.samples;
+  }
+  CHECK(beeps == 2 * beepsPerPeriod);
+
+  for (int i = 0; i < 2 * period; i++)
+  {
+    CHECK(samples[i] == samples[i + period]);
+  }
+
+  synth.stop();
+  CHECK(!synth.playing());
+
+  printf("%d samples, %d beeps\n", numSamples, beeps);
+  free(samples);
+  return 0;
+}
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Decode ReMEDer binary log frames (see src/Log.h) back into text.
+
+Usage:
+    logdecode.py capture.bin          decode a raw capture
+    logdecode.py /dev/ttyUSB0 [baud]  read a serial port (needs pyserial)
+    logdecode.py < capture.bin        decode stdin
+"""
+
+import os
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+FRAME_SIZE = 6
+LOG_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src", "Log.h")
+
+
+def load_messages(path):
+    """Read the message table in the order the enum numbers it."""
+    with open(path) as f:
+        return re.findall(r'^\s*X\((\w+),\s*"(.*)"\)', f.read(), re.MULTILINE)
+
+
+def format_frame(messages, frame):
+    message_id = frame[1]
+    (value,) = struct.unpack("<i", bytes(frame[2:]))
+    if message_id >= len(messages):
+        return "Unknown message %d: %d" % (message_id, value)
+    text = messages[message_id][1]
+    return "%s %d" % (text, value) if text.endswith(":") else text
+
+
+def decode(stream, messages):
+    frame = []
+    while True:
+        data = stream.read(1)
+        if not data:
+            return
+        byte = data[0]
+        # Resynchronize on the sync byte after a partial or corrupt frame.
+        if not frame and byte != FRAME_SYNC:
+            continue
+        frame.append(byte)
+        if len(frame) == FRAME_SIZE:
+            print(format_frame(messages, frame), flush=True)
+            frame = []
+
+
+def main():
+    messages = load_messages(LOG_HEADER)
+
+    if len(sys.argv) < 2:
+        decode(sys.stdin.buffer, messages)
+    elif sys.argv[1].startswith("/dev/") or sys.argv[1].upper().startswith("COM"):
+        import serial
+
+        baud = int(sys.argv[2]) if len(sys.argv) > 2 else 115200
+        with serial.Serial(sys.argv[1], baud) as port:
+            decode(port, messages)
+    else:
+        with open(sys.argv[1], "rb") as f:
+            decode(f, messages)
+
+
+if __name__ == "__main__":
+    main()